@@ -0,0 +1,64 @@
+#include <iRRAM/lib.h>
+#include <cstdlib>
+#include <vector>
+
+/* Throughput of exec_batch() compared to one exec() per input, with and
+ * without a session.
+ *
+ * "batch_timings [inputs] [digits]": approximates exp(sin(x)) for the given
+ * number of inputs x in [0,1) to the given number of decimal digits. */
+
+using namespace iRRAM;
+
+static double cputime()
+{
+	double t;
+	unsigned m;
+	resources(t, m);
+	return t;
+}
+
+static DYADIC f(const int &i, int n, int p)
+{
+	REAL x = REAL(i) / n;
+	return approx(exp(sin(x)), p);
+}
+
+int main(int argc, char **argv)
+{
+	iRRAM_initialize2(&argc, argv);
+
+	int n      = argc > 1 ? atoi(argv[1]) : 10000;
+	int digits = argc > 2 ? atoi(argv[2]) : 50;
+	int p      = -10 * digits / 3;
+
+	std::vector<int> in(n);
+	for (int i = 0; i < n; i++)
+		in[i] = i;
+
+	double t0 = cputime();
+	std::vector<DYADIC> r1(n);
+	for (int i = 0; i < n; i++)
+		r1[i] = exec(f, in[i], n, p);
+	double t1 = cputime();
+	{
+		session s;
+		for (int i = 0; i < n; i++)
+			r1[i] = s.exec(f, in[i], n, p);
+	}
+	double t2 = cputime();
+	std::vector<DYADIC> r2 = exec_batch([n,p](const int &i){ return f(i, n, p); }, in);
+	double t3 = cputime();
+
+	int diff = 0;
+	for (int i = 0; i < n; i++)
+		diff += !exec([](const DYADIC &a, const DYADIC &b, int p){
+			return bool(abs(REAL(a) - REAL(b)) < scale(REAL(1), p + 1));
+		}, r1[i], r2[i], p);
+
+	std::cout << "inputs: " << n << ", digits: " << digits << "\n"
+	          << "exec loop:    " << n / (t1 - t0) << " inputs/s\n"
+	          << "session loop: " << n / (t2 - t1) << " inputs/s\n"
+	          << "exec_batch:   " << n / (t3 - t2) << " inputs/s\n";
+	return diff != 0;
+}
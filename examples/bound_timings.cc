@@ -0,0 +1,72 @@
+#include <iRRAM/lib.h>
+#include <cstdio>
+#include <cstdlib>
+
+/* Speed of the convergence tests on the double intervals of the first
+ * iteration.
+ *
+ * "bound_timings [n]" sums the Taylor series of sin and exp n times (default:
+ * one hundred thousand) up to an error of 2^-50, with the loops
+ * while (!bound(e, prec)) of sin_taylor() and exp_approx(). */
+
+using namespace iRRAM;
+
+static double cputime()
+{
+	double t;
+	unsigned m;
+	resources(t, m);
+	return t;
+}
+
+enum { PREC = -50 };
+
+static REAL sin_series(const REAL &x)
+{
+	REAL x2 = square(x), e = x, z = x;
+	int i = 1;
+	while (!bound(e, PREC) || !bound(e, -1)) {
+		e *= x2 / (-2 * i * (2 * i + 1));
+		z += e;
+		i++;
+	}
+	return z;
+}
+
+static REAL exp_series(const REAL &x)
+{
+	REAL e = x, z = 1 + e;
+	int i = 1;
+	while (!bound(e, PREC)) {
+		i += 1;
+		e *= x / i;
+		z += e;
+	}
+	return z;
+}
+
+template <typename F>
+static REAL bench(const char *name, long n, F f)
+{
+	REAL r = 0;
+	double t = cputime();
+	for (long k = 0; k < n; k++)
+		r += f(scale(REAL(int(k % 64) + 1), -7));
+	t = cputime() - t;
+	std::printf("%-6s %8.1f ns/series\n", name, t / n * 1e9);
+	return r;
+}
+
+static REAL compute(const long &n)
+{
+	REAL r = bench("sin", n, sin_series);
+	return r + bench("exp", n, exp_series);
+}
+
+int main(int argc, char **argv)
+{
+	iRRAM_initialize2(&argc, argv);
+	long n = argc > 1 ? std::atol(argv[1]) : 100000;
+	exec(compute, n);
+	return 0;
+}
@@ -0,0 +1,65 @@
+#include <iRRAM/lib.h>
+#include <cstdio>
+#include <cstdlib>
+
+/* Speed of the double intervals used by REAL in the first iteration.
+ *
+ * "double_pair_timings [n]" applies each operation n times (default: ten
+ * million) to REALs that stay at double precision. Compile with
+ * -DiRRAM_NO_SIMD for the portable kernels or with -mavx for the AVX ones to
+ * compare. */
+
+using namespace iRRAM;
+
+static double cputime()
+{
+	double t;
+	unsigned m;
+	resources(t, m);
+	return t;
+}
+
+enum { N = 256 };
+
+template <typename F>
+static REAL bench(const char *name, long n, const std::vector<REAL> &x,
+                  const std::vector<REAL> &y, F f)
+{
+	std::vector<REAL> z(N);
+	double t = cputime();
+	for (long k = 0; k < n; k += N)
+		for (int i = 0; i < N; i++)
+			z[i] = f(x[i], y[i]);
+	t = cputime() - t;
+	std::printf("%-8s %6.2f ns/op\n", name, t / n * 1e9);
+	return z[0];
+}
+
+static REAL compute(const long &n)
+{
+	std::vector<REAL> x(N), y(N);
+	/* signs that the branch predictor cannot learn */
+	for (int i = 0; i < N; i++) {
+		x[i] = REAL(i * 37 % N - N / 2) / 7;
+		y[i] = REAL(2 * (i * 101 % N) - N + 1) / 3;
+	}
+	REAL r;
+	r += bench("add", n, x, y, [](const REAL &a, const REAL &b){ return a + b; });
+	r += bench("sub", n, x, y, [](const REAL &a, const REAL &b){ return a - b; });
+	r += bench("mul", n, x, y, [](const REAL &a, const REAL &b){ return a * b; });
+	r += bench("div", n, x, y, [](const REAL &a, const REAL &b){ return a / b; });
+	r += bench("square", n, x, y, [](const REAL &a, const REAL &){ return square(a); });
+	r += bench("horner", n, x, y, [](const REAL &a, const REAL &b){
+		return ((a * b + 3) * b - a) * b + 1;
+	});
+	return r;
+}
+
+int main(int argc, char **argv)
+{
+	iRRAM_initialize2(&argc, argv);
+
+	long n = argc > 1 ? atol(argv[1]) : 10000000;
+	exec(compute, n);
+	return 0;
+}
@@ -1,6 +1,8 @@
 #include <iostream>
 #include <vector>
+#include <cstring>
 #include <iRRAM/lib.h>
+#include <iRRAM/speculative.h> // link with -pthread
 
 
 using namespace std;
@@ -13,7 +15,10 @@ void iterate(REAL nu[], const int N, const int iterations);
 int main(int argc, char* argv[])
 {
   iRRAM_initialize(argc, argv);
-    
+
+  // "feig-2013 <iterations> speculative" races several precision levels
+  if (argc > 2 && !strcmp(argv[2], "speculative"))
+    return iRRAM::exec_speculative(initialize, argc, argv);
   return iRRAM::exec(initialize, argc, argv);
 }
 
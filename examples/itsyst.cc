@@ -104,10 +104,31 @@ void itsyst_with_INTEGER(int count,int width){
 }
 
 
+// The orbit rounded to 2*i+20 bits after step i: the precision needed grows
+// with the number of steps, so the run is interrupted by several
+// reiterations. With checkpoints, a reiteration resumes from the last rounded
+// value instead of recomputing the whole orbit at the higher precision.
+
+void itsyst_REAL_rounded(int count,int width,bool use_checkpoints){
+
+  REAL x = 0.5;
+  int i = 0;
+
+  if (use_checkpoints) restore_checkpoint(x,i);
+  for ( ; i<=count; i++ ) {
+    if ( (i<100) || (i%10)==0 ) {
+      cout << setRwidth(width) << x  << " : " << setw(4) << i << "\n";
+    }
+    x= approx(3.75*x*(1-x),-2*i-20);
+    if (use_checkpoints) checkpoint(x,i+1);
+  }
+}
+
+
 void compute(){
   int test,count,width;
   cout << "\nIterated functions system: x = 3.75*x*(1-x)\n";
-  cout << "\nHow to compute (1=double, 2=RATIONAL, 3=REAL, 4=with_INTEGER, 5=with_Lipschitz, 6=with_L+D) : ";
+  cout << "\nHow to compute (1=double, 2=RATIONAL, 3=REAL, 4=with_INTEGER, 5=with_Lipschitz, 6=with_L+D,\n  7=REAL rounded, 8=REAL rounded with checkpoints) : ";
   cin  >> test;
   cout << "How many values: ";
   cin  >> count;
@@ -133,6 +154,12 @@ void compute(){
      case 6:;
        itsyst_REAL_with_lipschitz_condition_and_domain(count,width);
      break;
+     case 7:;
+       itsyst_REAL_rounded(count,width,false);
+     break;
+     case 8:;
+       itsyst_REAL_rounded(count,width,true);
+     break;
   }
   cout << "\n";
 }
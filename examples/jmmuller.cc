@@ -1,4 +1,5 @@
 #include "iRRAM.h"
+#include "iRRAM/REAL_expr.h"
 
 using namespace iRRAM;
 
@@ -91,11 +92,54 @@ void jmm_REAL(int count){
   cout << REAL(a) << " " << count <<"\n" ;
 }
 
+// the same, with the expression evaluated as one tree (see REAL_expr.h)
+
+void jmm_REAL_lazy(int count){
+
+  REAL a= REAL(11)/2, b=REAL(61)/11, c;
+
+  for (long i=0;i<count;i++ ) {
+
+    if (print_flag) {
+      cout << REAL(a) << " " << i <<"\n" ;
+    }
+
+    c=111-(1130-3000/lazy(a))/b;
+    a=b; b=c;   
+
+  }
+  cout << REAL(a) << " " << count <<"\n" ;
+}
+
+
+// a and b rounded to 4*i+20 bits after step i; the precision needed grows
+// with i. With checkpoints a reiteration continues from the last rounded pair.
+
+void jmm_REAL_rounded(int count,bool use_checkpoints){
+
+  REAL a= REAL(11)/2, b=REAL(61)/11, c;
+  long i=0;
+
+  if (use_checkpoints) restore_checkpoint(a,b,i);
+  for (;i<count;i++ ) {
+
+    if (print_flag) {
+      cout << REAL(a) << " " << i <<"\n" ;
+    }
+
+    c=111-(1130-3000/a)/b;
+    a=b; b=approx(c,-4*i-20);
+    if (use_checkpoints) checkpoint(a,b,i+1);
+
+  }
+  cout << REAL(a) << " " << count <<"\n" ;
+}
+
 
 void compute(){
   int test,count;
   cout << "\nJMM-example: c=111-(1130-3000/a)/b\n";
-  cout << "\nHow to compute (1=float, 2=double, 3=DYADIC, 4=RATIONAL, 5=REAL) : ";
+  cout << "\nHow to compute (1=float, 2=double, 3=DYADIC, 4=RATIONAL, 5=REAL,\n  6=REAL rounded, 7=REAL rounded with checkpoints,\n  8=REAL expression template) : ";
   cin  >> test;
   cout << "How many values: ";
   cin  >> count;
@@ -125,6 +169,15 @@ void compute(){
      case 5:;
        jmm_REAL(count);
      break;
+     case 6:;
+       jmm_REAL_rounded(count,false);
+     break;
+     case 7:;
+       jmm_REAL_rounded(count,true);
+     break;
+     case 8:;
+       jmm_REAL_lazy(count);
+     break;
   }
   cout << "\n";
 }
@@ -0,0 +1,81 @@
+#include <iRRAM/lib.h>
+#include <cstdlib>
+
+/* Compares the cost of reiterations signalled by exceptions with the one of
+ * deferred reiterations (see iRRAM::deferred_reiteration).
+ *
+ * "reiterate_timings [steps] [runs]": each run of "orbit" follows the orbit
+ * of the logistic map for the given number of steps and counts the points in
+ * the upper half of [0,1]. Every comparison may fail and lead to a
+ * reiteration. Each run of "late" sums 1/k for k = steps..1 with recursive
+ * calls, and only the innermost one makes a comparison that fails in the
+ * first iteration. */
+
+using namespace iRRAM;
+
+static double cputime()
+{
+	double t;
+	unsigned m;
+	resources(t, m);
+	return t;
+}
+
+static int orbit(int steps, int seed)
+{
+	REAL c = REAL(39)/10;
+	REAL x = REAL(seed)/(seed+1);
+	int upper = 0;
+	for (int i = 0; i < steps; i++) {
+		x = c * x * (1 - x);
+		if (x > REAL(0.5))
+			upper++;
+	}
+	return upper;
+}
+
+static REAL late_sum(int k, const REAL &eps)
+{
+	if (k == 0)
+		return eps > 0 ? REAL(1) : REAL(0);
+	return late_sum(k - 1, eps) + REAL(1) / k;
+}
+
+static int late(int steps, int seed)
+{
+	REAL eps = REAL(seed) / 3 * 3 - seed + scale(REAL(1), -80);
+	return (int)late_sum(steps, eps).as_double(20);
+}
+
+static long long timed(int f(int, int), bool deferred, int steps, int runs,
+                       double &t)
+{
+	deferred_reiteration mode(deferred);
+	long long sum = 0;
+	double t0 = cputime();
+	for (int r = 0; r < runs; r++)
+		sum += exec(f, steps, r + 1);
+	t = cputime() - t0;
+	return sum;
+}
+
+int main(int argc, char **argv)
+{
+	iRRAM_initialize2(&argc, argv);
+
+	int steps = argc > 1 ? atoi(argv[1]) : 200;
+	int runs  = argc > 2 ? atoi(argv[2]) : 200;
+
+	std::cout << "steps: " << steps << ", runs: " << runs << "\n";
+	bool same = true;
+	for (auto f : { orbit, late }) {
+		double t_exc, t_def;
+		long long r_exc = timed(f, false, steps, runs, t_exc);
+		long long r_def = timed(f, true, steps, runs, t_def);
+		same = same && r_exc == r_def;
+		std::cout << (f == orbit ? "orbit" : "late") << "\n"
+		          << "  exceptions: " << t_exc << "s (result " << r_exc << ")\n"
+		          << "  deferred:   " << t_def << "s (result " << r_def << ")\n";
+	}
+	return same ? 0 : 1;
+}
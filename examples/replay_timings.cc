@@ -0,0 +1,53 @@
+#include <iRRAM/lib.h>
+#include <cstdlib>
+
+/* Cost of replaying the multi-valued cache in reiterations.
+ *
+ * "replay_timings [choices] [runs]": each run takes the given number of
+ * decisions (comparisons, size() and approx()) on the terms of a sequence
+ * and finally asks for a precision that needs several reiterations, which
+ * replay all the decisions taken before. */
+
+using namespace iRRAM;
+
+static double cputime()
+{
+	double t;
+	unsigned m;
+	resources(t, m);
+	return t;
+}
+
+static int choices(int n, int seed)
+{
+	REAL x = REAL(seed) / (seed + 2);
+	int r = 0;
+	for (int i = 0; i < n; i++) {
+		x = x * x / 2 + REAL(1) / 3;
+		switch (i % 3) {
+		case 0: r += bool(x > REAL(1) / 2); break;
+		case 1: r += size(x); break;
+		case 2: r += approx(x, -60) > DYADIC(0.5); break;
+		}
+	}
+	/* needs several iterations */
+	return r + (approx(x, -3000) > DYADIC(0.5));
+}
+
+int main(int argc, char **argv)
+{
+	iRRAM_initialize2(&argc, argv);
+
+	int n    = argc > 1 ? atoi(argv[1]) : 3000;
+	int runs = argc > 2 ? atoi(argv[2]) : 20;
+
+	double t0 = cputime();
+	long long sum = 0;
+	for (int r = 0; r < runs; r++)
+		sum += exec(choices, n, r + 1);
+	double t = cputime() - t0;
+
+	std::cout << "choices: " << n << ", runs: " << runs << "\n"
+	          << "time: " << t << "s (result " << sum << ")\n";
+	return 0;
+}
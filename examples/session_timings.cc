@@ -0,0 +1,46 @@
+#include <iRRAM/lib.h>
+#include <cstdlib>
+
+/* Per-call overhead of exec() compared to session::exec().
+ *
+ * "session_timings [calls]" evaluates a trivial function the given number of
+ * times (default: one million) in both ways. */
+
+using namespace iRRAM;
+
+static double cputime()
+{
+	double t;
+	unsigned m;
+	resources(t, m);
+	return t;
+}
+
+static int trivial(const int &i)
+{
+	return REAL(i) > -1 ? 1 : 0;
+}
+
+int main(int argc, char **argv)
+{
+	iRRAM_initialize2(&argc, argv);
+
+	long n = argc > 1 ? atol(argv[1]) : 1000000;
+
+	long r1 = 0, r2 = 0;
+	double t0 = cputime();
+	for (long i = 0; i < n; i++)
+		r1 += exec(trivial, int(i));
+	double t1 = cputime();
+	{
+		session s;
+		for (long i = 0; i < n; i++)
+			r2 += s.exec(trivial, int(i));
+	}
+	double t2 = cputime();
+
+	std::cout << "calls: " << n << "\n"
+	          << "exec:          " << (t1 - t0) / n * 1e9 << " ns/call\n"
+	          << "session::exec: " << (t2 - t1) / n * 1e9 << " ns/call\n";
+	return r1 != r2;
+}
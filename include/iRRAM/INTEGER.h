@@ -44,6 +44,7 @@ class INTEGER
 	friend class RATIONAL;
 	friend class REAL;
 	friend class DYADIC;
+	friend struct tape_codec<INTEGER>;
 
 public:
 
@@ -67,13 +67,13 @@ MA 02111-1307, USA.
 #define MP_mp_to_double(z)	mpfr_get_d(z,GMP_RNDN)
 #define MP_double_to_mp(d,z)                                                   \
 	do {   	                                                               \
-		mpfr_set_prec(z,53);                                           \
+		ext_mpfr_set_prec(z,53);                                       \
 		mpfr_set_d(z,d,iRRAM_mpfr_rounding_mode);                      \
 	} while (0)
 
 #define MP_int_to_mp(i,z)                                                      \
 	do {                                                                   \
-		mpfr_set_prec(z,32);                                           \
+		ext_mpfr_set_prec(z,32);                                       \
 		mpfr_set_si(z,i,iRRAM_mpfr_rounding_mode);                     \
 	} while (0)
 #define MP_int_to_INTEGER(i,z)	mpz_set_si(z,i)
@@ -116,13 +116,17 @@ MA 02111-1307, USA.
 #define MP_rat_duplicate_wo_init(z1,z2)	rat_gmp_duplicate_wo_init(z1,z2) 
 
 /* copy z1 to z2, but precision p is sufficient */
-#define MP_copy(z1,z2,p)		ext_mpfr_duplicate_wo_init(z1,z2)
+#define MP_copy(z1,z2,p)		ext_mpfr_copy(z1,z2,p)
 
 
-/* Multiple precision arithmetic, deterministic results */
+/* Multiple precision arithmetic, deterministic results;
+   for add, sub, mul, div, their integer variants and shift z may be an operand */
 #define MP_add(z1,z2,z,p)  ext_mpfr_add(z1,z2,z,p)
 #define MP_sub(z1,z2,z,p)  ext_mpfr_sub(z1,z2,z,p)
 #define MP_mul(z1,z2,z,p)  ext_mpfr_mul(z1,z2,z,p) 
+#define MP_fma(z1,z2,z3,z,p) ext_mpfr_fma(z1,z2,z3,z,p)
+#define MP_fms(z1,z2,z3,z,p) ext_mpfr_fms(z1,z2,z3,z,p)
+#define MP_fmma(z1,z2,z3,z4,z,p) ext_mpfr_fmma(z1,z2,z3,z4,z,p)
 #define MP_div(z1,z2,z,p)  ext_mpfr_div(z1,z2,z,p) 
 #define MP_addi(z1,z2,z,p) ext_mpfr_add_i(z1,z2,z,p)
 #define MP_subi(z1,z2,z,p) ext_mpfr_sub_i(z1,z2,z,p)
@@ -141,6 +145,9 @@ MA 02111-1307, USA.
 #define MP_mv_add(z1,z2,z,p)  MP_add(z1,z2,z,p)  
 #define MP_mv_sub(z1,z2,z,p)  MP_sub(z1,z2,z,p)  
 #define MP_mv_mul(z1,z2,z,p)  MP_mul(z1,z2,z,p)  
+#define MP_mv_fma(z1,z2,z3,z,p) MP_fma(z1,z2,z3,z,p)
+#define MP_mv_fms(z1,z2,z3,z,p) MP_fms(z1,z2,z3,z,p)
+#define MP_mv_fmma(z1,z2,z3,z4,z,p) MP_fmma(z1,z2,z3,z4,z,p)
 #define MP_mv_div(z1,z2,z,p)  MP_div(z1,z2,z,p)  
 #define MP_mv_addi(z1,z2,z,p) MP_addi(z1,z2,z,p) 
 #define MP_mv_subi(z1,z2,z,p) MP_subi(z1,z2,z,p) 
@@ -265,6 +272,19 @@ typedef mpz_ptr  int_mpfr_type;
 
 #define iRRAM_EXT_MPFR_CACHE_SIZE 1000 /* TODO: make adjustable during init() */
 
+/* Number of limbs stored together with the variable itself, see
+ * ext_mpfr_set_prec(). */
+#define iRRAM_EXT_MPFR_INLINE_LIMBS 8
+
+/* The memory behind each mpfr_ptr handed out by ext_mpfr_init(). Up to
+ * iRRAM_EXT_MPFR_INLINE_LIMBS limbs the significand is kept in 'limbs' using
+ * MPFR's custom interface, so the variable and its significand share one
+ * allocation; larger precisions spill to a significand allocated by MPFR. */
+struct iRRAM_ext_mpfr_block {
+	__mpfr_struct z;
+	mp_limb_t limbs[iRRAM_EXT_MPFR_INLINE_LIMBS];
+};
+
 struct iRRAM_ext_mpfr_cache_t {
 	int free_var_count;
 	int ext_mpfr_var_count;
@@ -286,6 +306,60 @@ void ext_mpfr_getsize(const mpfr_t z,ext_mpfr_sizetype* s);
 }
 #endif
 
+/* whether the significand of z lies in the inline limbs of its block */
+int ext_mpfr_is_inline(mpfr_srcptr z);
+
+inline int ext_mpfr_is_inline(mpfr_srcptr z)
+{
+	return mpfr_custom_get_significand(z) ==
+	       ((const struct iRRAM_ext_mpfr_block *)z)->limbs;
+}
+
+/*! \brief Replacement of mpfr_set_prec() for variables from ext_mpfr_init().
+ *
+ * Moves the significand between the inline limbs and the heap as needed; the
+ * value of z becomes NaN just as with mpfr_set_prec(). */
+void ext_mpfr_set_prec(mpfr_ptr z, mpfr_prec_t p);
+
+inline void ext_mpfr_set_prec(mpfr_ptr z, mpfr_prec_t p)
+{
+	struct iRRAM_ext_mpfr_block *b = (struct iRRAM_ext_mpfr_block *)z;
+	if (mpfr_custom_get_size(p) <= sizeof(b->limbs)) {
+		if (!ext_mpfr_is_inline(z))
+			mpfr_clear(z);
+		mpfr_custom_init_set(z, MPFR_NAN_KIND, 0, p, b->limbs);
+	} else if (ext_mpfr_is_inline(z)) {
+		mpfr_init2(z, p);
+	} else {
+		mpfr_set_prec(z, p);
+	}
+}
+
+/*! \brief Increases the precision of a variable from ext_mpfr_init() to p
+ * while keeping its value. */
+void ext_mpfr_raise_prec(mpfr_ptr z, mpfr_prec_t p);
+
+inline void ext_mpfr_raise_prec(mpfr_ptr z, mpfr_prec_t p)
+{
+	struct iRRAM_ext_mpfr_block *b = (struct iRRAM_ext_mpfr_block *)z;
+	if (!ext_mpfr_is_inline(z)) {
+		mpfr_prec_round(z, p, MPFR_RNDN);
+	} else if (mpfr_custom_get_size(p) <= sizeof(b->limbs)) {
+		/* the significand is aligned to the most significant limb */
+		size_t n = mpfr_custom_get_size(mpfr_get_prec(z)) / sizeof(mp_limb_t);
+		size_t m = mpfr_custom_get_size(p) / sizeof(mp_limb_t);
+		memmove(b->limbs + (m - n), b->limbs, n * sizeof(mp_limb_t));
+		memset(b->limbs, 0, (m - n) * sizeof(mp_limb_t));
+		mpfr_custom_init_set(z, mpfr_custom_get_kind(z),
+		                     mpfr_custom_get_exp(z), p, b->limbs);
+	} else {
+		/* old still refers to the inline limbs */
+		__mpfr_struct old = *z;
+		mpfr_init2(z, p);
+		mpfr_set(z, &old, MPFR_RNDN);
+	}
+}
+
 
 mpfr_ptr ext_mpfr_init(struct iRRAM_ext_mpfr_cache_t *);
 
@@ -296,8 +370,11 @@ inline mpfr_ptr ext_mpfr_init(struct iRRAM_ext_mpfr_cache_t *cache)
 		cache->free_var_count -= 1;
 		z = cache->free_vars[cache->free_var_count];
 	} else {
-		z = (mpfr_ptr)malloc(sizeof(mpfr_t));
-		mpfr_init(z);
+		struct iRRAM_ext_mpfr_block *b = (struct iRRAM_ext_mpfr_block *)
+			malloc(sizeof(struct iRRAM_ext_mpfr_block));
+		z = &b->z;
+		mpfr_custom_init_set(z, MPFR_NAN_KIND, 0, mpfr_get_default_prec(),
+		                     b->limbs);
 		cache->total_alloc_var_count++;
 	}
 	cache->ext_mpfr_var_count += 1;
@@ -316,7 +393,8 @@ inline void ext_mpfr_free(struct iRRAM_ext_mpfr_cache_t *cache, mpfr_ptr z)
 		cache->free_vars[cache->free_var_count] = z;
 		cache->free_var_count += 1;
 	} else {
-		mpfr_clear(z);
+		if (!ext_mpfr_is_inline(z))
+			mpfr_clear(z);
 		free(z);
 		cache->total_freed_var_count++;
 	}
@@ -27,38 +27,24 @@ MA 02111-1307, USA.
 
 #include <cmath>
 #include <vector>
+#include <cstdint>
+#include <limits>
 
 #include <iRRAM/helper-templates.hh>
 #include <iRRAM/LAZYBOOLEAN.h>
 #include <iRRAM/INTEGER.h>
 #include <iRRAM/STREAMS.h> /* float_form, iRRAM_DEBUG* */
-
-#ifdef __SSE2__at_the_moment_not_used_due_to_alignment_problems_in_gcc_4_3
-#include <emmintrin.h>
-#define _use_SSE2_
-#endif
+#include <iRRAM/double_pair.h>
+#include <iRRAM/double_double.h>
 
 namespace iRRAM {
 
+namespace expr { struct access; } /* see REAL_expr.h */
+
 /*! \ingroup types */
 class REAL final : conditional_comparison_overloads<REAL,LAZY_BOOLEAN>
 {
-	struct double_pair {
-	#ifdef _use_SSE2__
-		union {
-			struct {
-				double lower_pos, upper_neg;
-			};
-			__m128d sse_data;
-		};
-		double_pair(const __m128d& sse) noexcept : sse_data(sse) {}
-	#else
-		double lower_pos, upper_neg;
-	#endif
-		double_pair(const double l,const double u) noexcept
-		: lower_pos(l), upper_neg(u) {}
-		double_pair() noexcept {}
-	};
+	typedef internal::double_pair double_pair;
 public:
 
 	// Constructors: -------------------------------
@@ -87,6 +73,14 @@ public:
 
 	friend REAL operator+(const REAL &, const REAL &);
 
+	/* operands about to be destroyed lend their MP storage to the result */
+	template <typename X,typename Y>
+	friend enable_if_rvalue_op<REAL,X,Y> operator+(X &&x, Y &&y);
+	template <typename X,typename Y>
+	friend enable_if_lvalue_rvalue_op<REAL,X,Y> operator+(X &&x, Y &&y);
+	template <typename X,typename I>
+	friend enable_if_rvalue_int_op<REAL,X,I> operator+(X &&x, const I &n);
+
 	REAL & operator+=(const REAL &);
 
 	template <typename A,typename B>
@@ -98,6 +92,15 @@ public:
 
 	friend REAL operator-(const REAL &x, const REAL &y);
 
+	template <typename X,typename Y>
+	friend enable_if_rvalue_op<REAL,X,Y> operator-(X &&x, Y &&y);
+	template <typename X,typename Y>
+	friend enable_if_lvalue_rvalue_op<REAL,X,Y> operator-(X &&x, Y &&y);
+	template <typename X,typename I>
+	friend enable_if_rvalue_int_op<REAL,X,I> operator-(X &&x, const I &n);
+	template <typename X,typename I>
+	friend enable_if_rvalue_int_op<REAL,X,I> operator-(const I &n, X &&x);
+
 	template <typename A,typename B>
 	friend enable_if_compat<REAL,A,B> operator-(const A &a, const B &b);
 
@@ -111,32 +114,55 @@ public:
 
 	friend REAL operator*(const REAL &x, const REAL &y);
 
+	template <typename X,typename Y>
+	friend enable_if_rvalue_op<REAL,X,Y> operator*(X &&x, Y &&y);
+	template <typename X,typename Y>
+	friend enable_if_lvalue_rvalue_op<REAL,X,Y> operator*(X &&x, Y &&y);
+	template <typename X,typename I>
+	friend enable_if_rvalue_int_op<REAL,X,I> operator*(X &&x, const I &n);
+
 	template <typename A,typename B>
 	friend enable_if_compat<REAL,A,B> operator*(const A &a, const B &b);
 
 	template <typename A,typename B>
 	friend enable_if_compat<REAL,A,B> operator*(const B &b, const A &a);
 
-	REAL & operator*=(const REAL &y) { return *this = *this * y; }
+	REAL & operator*=(const REAL &y);
 	REAL & operator*=(      int   n);
 
 	friend REAL operator/(const REAL &x, const REAL &y);
 
+	template <typename X,typename Y>
+	friend enable_if_rvalue_op<REAL,X,Y> operator/(X &&x, Y &&y);
+	template <typename X,typename Y>
+	friend enable_if_lvalue_rvalue_op<REAL,X,Y> operator/(X &&x, Y &&y);
+	template <typename X,typename I>
+	friend enable_if_rvalue_int_op<REAL,X,I> operator/(X &&x, const I &n);
+
 	template <typename A,typename B>
 	friend enable_if_compat<REAL,A,B> operator/(const A &a, const B &b);
 
 	template <typename A,typename B>
 	friend enable_if_compat<REAL,A,B> operator/(const B &b, const A &a);
 
-	REAL & operator/=(const REAL &y) { return *this = *this / y; }
-//	REAL & operator/=(      int   n);
+	REAL & operator/=(const REAL &y);
+	REAL & operator/=(      int   n);
 
 	friend REAL   operator << (const REAL   &x,       int     n);
 	friend REAL   operator >> (const REAL   &x,       int     n);
 
 	friend REAL          sqrt        (const REAL &x);
+	friend REAL          exp         (const REAL &x);
+	friend REAL          log         (const REAL &x);
+	friend REAL          sin         (const REAL &x);
+	friend REAL          cos         (const REAL &x);
 	friend REAL          square      (const REAL &x);
+	friend REAL          fma         (const REAL &x, const REAL &y, const REAL &z);
+	friend REAL          fms         (const REAL &x, const REAL &y, const REAL &z);
+	friend REAL          fmma        (const REAL &a, const REAL &b,
+	                                  const REAL &c, const REAL &d);
 	friend REAL          scale       (const REAL &x, const int k);
+	friend REAL          scale       (REAL      &&x, const int k);
 
 	// Comparisons: --------------------------------
 
@@ -228,9 +254,15 @@ friend REAL lipschitz (REAL f(const REAL&),
 
 friend void swap(REAL &, REAL &) noexcept;
 friend REAL strtoREAL2(const char *s, char **endptr);
+friend class REALVECTOR;
+friend struct expr::access;
+friend REAL abs(const std::vector<REAL>& x);
 
 // implementational issues: --------------------
 public:
+	/* `dp` is only used if `value == NULL` and `error` and `vsize` only
+	 * otherwise, so they share storage. */
+	union {
 	/*!
 	 * \brief Closed `double` interval containg x.
 	 *
@@ -238,24 +270,14 @@ public:
 	 * documentation `dp.lower_pos` is denoted as \f$x_L\f$, `dp.upper_neg`
 	 * is denoted as \f$x_{-U}\f$ and likewise `-dp.upper_neg` is \f$x_U\f$.
 	 * This way of approximating reals is only used in the \ref Iteration
-	 * with `actual_step == 1`.
+	 * with `actual_step == 1`. If dd() holds, `dp` holds the high parts of
+	 * double-double bounds instead, see dd().
 	 *
 	 * \invariant `value == NULL` \f$\Longrightarrow x_L\leq x\leq x_U\f$.
 	 */
 	double_pair   dp;
 
-	/*!
-	 * \brief Center of the current interval containing the real value x.
-	 *
-	 * Let this REAL object denote \f$x\in\mathbb R\f$, then in this
-	 * documentation `value` is referred to as \f$x_c\f$. It may differ from
-	 * one \ref Iteration to the next.
-	 *
-	 * \invariant `value != NULL`
-	 * \f$\Longrightarrow|x-x_c|\leq x_\varepsilon\f$
-	 */
-	MP_type       value;
-
+	iRRAM_extension struct {
 	/*!
 	 * \brief Radius of the current interval containing the real value x.
 	 *
@@ -282,6 +304,45 @@ public:
 	 *                                 \leq|x_c|<\hat x=m\cdot2^e\f$
 	 */
 	sizetype      vsize;
+	};
+	};
+
+	/*!
+	 * \brief Center of the current interval containing the real value x.
+	 *
+	 * Let this REAL object denote \f$x\in\mathbb R\f$, then in this
+	 * documentation `value` is referred to as \f$x_c\f$. It may differ from
+	 * one \ref Iteration to the next.
+	 *
+	 * \invariant `value != NULL`
+	 * \f$\Longrightarrow|x-x_c|\leq x_\varepsilon\f$
+	 */
+	MP_type       value;
+
+	/*!
+	 * \brief Low parts of double-double bounds, NULL for all other REALs.
+	 *
+	 * They live in a separate allocation, taken from the free list
+	 * state_t::dd_low_cache, so that the double tier, which is the one
+	 * used most, does not pay for them in the size of REAL.
+	 * Only used if `value == NULL`.
+	 */
+	internal::dd_low *dd_lo = nullptr;
+
+	/*!
+	 * \brief Whether the bounds are double-doubles.
+	 *
+	 * In the \ref Iteration "Iterations" after the first one with
+	 * `actual_prec >= state_t::dd_prec`, REALs are double-double
+	 * intervals outside of limits and other single_valued sections: then
+	 * \f$x_L\f$ is `dp.lower_pos + dd_lo->lower_pos` and \f$x_{-U}\f$ is
+	 * `dp.upper_neg + dd_lo->upper_neg`, see double_double.h. Only
+	 * meaningful if `value == NULL`.
+	 *
+	 * After such an Iteration failed, the next #iRRAM_DD_BACKOFF calls
+	 * to exec() on this thread go from doubles straight to MPFR.
+	 */
+	bool          dd                () const noexcept { return dd_lo != nullptr; }
 
 public:
 	void         adderror           (sizetype  error);
@@ -298,9 +359,15 @@ public:
 private:
 	REAL(MP_type y, sizetype errorinfo) noexcept;
 	REAL(const double_pair &ydp) noexcept;
-#ifdef _use_SSE2__
-	REAL(const __m128d     &y_sse) noexcept;
-#endif
+	REAL(const internal::dd_pair &y);
+
+	/* the interval is given by dp alone */
+	bool         dp_only            () const noexcept { return !value && !dd(); }
+	internal::dd_pair dd_interval   () const noexcept;
+	void         dd_from_dp         ();
+	void         dd_set             (const internal::dd_pair &y);
+	void         dd_clear           () noexcept;
+	void         copy_interval      (const REAL   &y);
 
 	void         mp_copy            (const REAL   &);
 	void         mp_copy_init       (const REAL   &);
@@ -312,10 +379,15 @@ private:
 	REAL         mp_addition        (const REAL   &y) const;
 	REAL         mp_addition        (const int     i) const;
 	REAL &       mp_eqaddition      (const REAL   &y);
+	REAL &       mp_eqaddition      (const int     i);
 //	REAL         mp_addition        (const double  i) const; //fehlt noch
 	REAL         mp_subtraction     (const REAL   &y) const;
 	REAL         mp_subtraction     (const int     i) const;
 	REAL         mp_invsubtraction  (const int     i) const;
+	REAL &       mp_eqsubtraction   (const REAL   &y);
+	REAL &       mp_eqsubtraction   (const int     i);
+	REAL &       mp_eqinvsubtraction(const REAL   &x);
+	REAL &       mp_eqinvsubtraction(const int     i);
 	REAL         mp_multiplication  (const REAL   &y) const;
 	REAL         mp_multiplication  (const int     y) const;
 	REAL &       mp_eqmultiplication(const REAL   &y);
@@ -324,10 +396,37 @@ private:
 	REAL         mp_division        (const REAL   &y) const;
 	REAL         mp_division        (const int     y) const;
 	REAL         mp_division        (const double  y) const;
+	REAL &       mp_eqdivision      (const REAL   &y);
+	REAL &       mp_eqdivision      (const int     i);
+	REAL &       mp_eqinvdivision   (const REAL   &x);
 	REAL         mp_square          ()                const;
+	REAL         mp_fma             (const REAL   &y, const REAL &z) const;
+	REAL         mp_fms             (const REAL   &y, const REAL &z) const;
+	REAL         mp_fmma            (const REAL   &b, const REAL &c,
+	                                 const REAL   &d) const;
 	REAL         mp_absval          ()                const;
 	REAL         mp_intervall_join  (const REAL   &y) const;
 	LAZY_BOOLEAN mp_less            (const REAL   &y) const;
+
+	REAL         dd_addition        (const REAL   &y) const;
+	REAL         dd_addition        (const int     i) const;
+	REAL         dd_subtraction     (const REAL   &y) const;
+	REAL         dd_subtraction     (const int     i) const;
+	REAL         dd_invsubtraction  (const int     i) const;
+	REAL         dd_multiplication  (const REAL   &y) const;
+	REAL         dd_multiplication  (const int     i) const;
+	REAL         dd_division        (const REAL   &y) const;
+	REAL         dd_division        (const int     i) const;
+	REAL         dd_square          ()                const;
+	REAL         dd_absval          ()                const;
+	REAL &       dd_eqaddition      (const REAL   &y);
+	REAL &       dd_eqsubtraction   (const REAL   &y);
+	REAL &       dd_eqsubtraction   (const int     i);
+	REAL &       dd_eqmultiplication(const REAL   &y);
+	REAL &       dd_eqmultiplication(const int     i);
+	REAL &       dd_eqdivision      (const REAL   &y);
+	REAL &       dd_eqdivision      (const int     i);
+	LAZY_BOOLEAN dd_less            (const REAL   &y) const;
 };
 
 /*! \relates REAL */
@@ -342,6 +441,31 @@ inline void     to_formal_ball(const REAL &r, DYADIC &center, sizetype &err)
 	r.to_formal_ball(center, err);
 }
 
+namespace internal {
+/* the multi-valued part of sub_exec(), see lib.h */
+bool sub_exec_cached(DYADIC &d, const state_t &st);
+void sub_exec_cache(const DYADIC &d, const state_t &st);
+REAL sub_exec_result(const DYADIC &d, int tol);
+
+/* thrown out of the iterations of a sub_exec() whose arguments are too
+ * imprecise for its tolerance */
+struct sub_exec_imprecise {
+	int prec_diff;
+};
+
+/* watches the error of the results of the iterations of a sub_exec(): the
+ * arguments are too imprecise if it does not decrease in
+ * sub_exec_max_stalls iterations in a row */
+class sub_exec_progress {
+	int least_error = std::numeric_limits<int>::max();
+	int stalls = 0;
+public:
+	void check(const REAL &y, int tol);
+};
+
+enum { sub_exec_max_stalls = 3 };
+}
+
 // for the sake of proving computational adequacy:
 // if q=module(f,x,p), then |z-x|<2^q => |f(z)-f(x)| < 2^p
 //! \related REAL
@@ -364,6 +488,14 @@ REAL power   (const REAL& x, int n);
 REAL modulo  (const REAL& x, const REAL& y);
 REAL maximum (const REAL& x, const REAL& y);
 REAL minimum (const REAL& x, const REAL& y);
+/*! \brief \f$x\cdot y+z\f$ with a single rounding error
+ *
+ * The errors of x and y are taken as independent, use square() for x*x. */
+REAL fma     (const REAL& x, const REAL& y, const REAL& z);
+/*! \brief \f$x\cdot y-z\f$ with a single rounding error */
+REAL fms     (const REAL& x, const REAL& y, const REAL& z);
+/*! \brief \f$a\cdot b+c\cdot d\f$ with a single rounding error */
+REAL fmma    (const REAL& a, const REAL& b, const REAL& c, const REAL& d);
 
 /****************************************************************************/
 // roots
@@ -444,7 +576,7 @@ std::string swrite(const REAL & x, const int p,
 
 //"private" internal  constructor
 inline REAL::REAL(MP_type y, sizetype errorinfo) noexcept
-: value(y), error(errorinfo)
+: error(errorinfo), value(y)
 {
     MP_getsize(value,vsize);
 }
@@ -453,10 +585,59 @@ inline REAL::REAL(MP_type y, sizetype errorinfo) noexcept
 inline REAL::REAL(const double_pair& ydp) noexcept
 : dp(ydp), value(nullptr) {}
 
-#ifdef _use_SSE2__
-inline REAL::REAL(const __m128d& y_sse) noexcept
-: dp(y_sse), value(nullptr) {}
-#endif
+//"private" internal  constructor
+inline REAL::REAL(const internal::dd_pair &y)
+: dp(y.lower_pos.hi, y.upper_neg.hi), value(nullptr),
+  dd_lo(state->dd_low_cache.alloc())
+{
+	*dd_lo = { y.lower_pos.lo, y.upper_neg.lo };
+}
+
+inline internal::dd_pair REAL::dd_interval() const noexcept
+{
+	if (!dd())
+		return { { dp.lower_pos, 0.0 }, { dp.upper_neg, 0.0 } };
+	return { { dp.lower_pos, dd_lo->lower_pos },
+	         { dp.upper_neg, dd_lo->upper_neg } };
+}
+
+inline void REAL::dd_from_dp()
+{
+	if (!dd_lo)
+		dd_lo = state->dd_low_cache.alloc();
+	*dd_lo = { 0.0, 0.0 };
+}
+
+/* sets the interval of *this, which is no MP number, reusing its dd_lo */
+inline void REAL::dd_set(const internal::dd_pair &y)
+{
+	dp = double_pair(y.lower_pos.hi, y.upper_neg.hi);
+	if (!dd_lo)
+		dd_lo = state->dd_low_cache.alloc();
+	*dd_lo = { y.lower_pos.lo, y.upper_neg.lo };
+}
+
+inline void REAL::dd_clear() noexcept
+{
+	if (dd_lo) {
+		state->dd_low_cache.free(dd_lo);
+		dd_lo = nullptr;
+	}
+}
+
+inline void REAL::copy_interval(const REAL &y)
+{
+	dp = y.dp;
+	if (iRRAM_unlikely(dd() || y.dd())) {
+		if (!y.dd())
+			dd_clear();
+		else {
+			if (!dd())
+				dd_lo = state->dd_low_cache.alloc();
+			*dd_lo = *y.dd_lo;
+		}
+	}
+}
 
 inline REAL::~REAL() 
 {
@@ -464,34 +645,54 @@ inline REAL::~REAL()
 		MP_clear(value);
 		value = nullptr;
 	}
+	if (iRRAM_unlikely(dd_lo))
+		dd_clear();
 }
 
 inline REAL::REAL() : REAL(0) {}
 
 inline REAL::REAL(int i) : dp((double)i,-(double)i), value(nullptr)
 {
-	if (iRRAM_unlikely(state->highlevel))
-		mp_from_int(i);
+	if (iRRAM_unlikely(state->highlevel)) {
+		if (state->ddlevel)
+			dd_from_dp();
+		else
+			mp_from_int(i);
+	}
 }
 
 inline REAL::REAL(double d) : dp(d,-d), value(nullptr)
 {
 	if (!std::isfinite(d))
 		throw iRRAM_Numerical_Exception(iRRAM_conversion_from_infinite);
-	if (iRRAM_unlikely(state->highlevel))
-		mp_from_double(d);
+	if (iRRAM_unlikely(state->highlevel)) {
+		if (state->ddlevel)
+			dd_from_dp();
+		else
+			mp_from_double(d);
+	}
 }
 
 inline REAL::REAL(const REAL& y) : dp(y.dp), value(nullptr)
 {
 	if (iRRAM_unlikely(y.value))
 		mp_copy_init(y);
+	else if (iRRAM_unlikely(y.dd())) {
+		dd_lo = state->dd_low_cache.alloc();
+		*dd_lo = *y.dd_lo;
+	}
 }
 
+/* dp(y.dp) also copies error and vsize; an MP or double-double number y is
+ * left as 0 */
 inline REAL::REAL(REAL &&y) noexcept
-: dp(y.dp), value(y.value), error(y.error), vsize(y.vsize)
+: dp(y.dp), value(y.value), dd_lo(y.dd_lo)
 {
-	y.value = nullptr;
+	if (iRRAM_unlikely(value || dd_lo)) {
+		y.value = nullptr;
+		y.dp = double_pair(0.0, -0.0);
+		y.dd_lo = nullptr;
+	}
 }
 
 inline REAL & REAL::mp_conv() const
@@ -515,21 +716,20 @@ inline REAL & REAL::operator=(const REAL & y)
 				this->mp_from_mp(y);
 			return *this;
 		}
-		dp = y.dp;
+		copy_interval(y);
 		mp_make_mp();
 		return *this;
 	}
-	dp = y.dp;
+	copy_interval(y);
 	return *this;
 }
 
 inline void swap(REAL &a, REAL &b) noexcept
 {
 	using std::swap;
-	swap(a.value, b.value);
-	swap(a.dp   , b.dp);
-	swap(a.error, b.error);
-	swap(a.vsize, b.vsize);
+	swap(a.value   , b.value);
+	swap(a.dp      , b.dp);
+	swap(a.dd_lo   , b.dd_lo);
 }
 
 /* TODO: what are iRRAM's semantics of REAL assignment?
@@ -556,14 +756,13 @@ inline REAL & REAL::operator=(REAL &&y) noexcept
 	return *this;
 }
 */
+/* if either is an MP or double-double number, y takes the old value of
+ * *this */
 inline REAL & REAL::operator=(REAL &&y) noexcept
 {
-	using std::swap;
-	swap(value, y.value);
-	if (iRRAM_unlikely(value)) {
-		vsize = y.vsize;
-		error = y.error;
-	} else
+	if (iRRAM_unlikely(value || y.value || dd_lo || y.dd_lo))
+		swap(*this, y);
+	else
 		dp = y.dp;
 	return *this;
 }
@@ -575,12 +774,9 @@ inline REAL operator+(const REAL& x, const REAL& y)
 {
 	if (iRRAM_unlikely(x.value||y.value))
 		return x.mp_conv().mp_addition(y.mp_conv());
-#ifdef _use_SSE2__
-	return REAL(_mm_add_pd(x.dp.sse_data,y.dp.sse_data));
-#else
-	return REAL(REAL::double_pair(x.dp.lower_pos+y.dp.lower_pos,
-	                              x.dp.upper_neg+y.dp.upper_neg));
-#endif
+	if (iRRAM_unlikely(x.dd()||y.dd()))
+		return x.dd_addition(y);
+	return REAL(internal::dp_ops::add(x.dp, y.dp));
 }
 
 template <typename A,typename B>
@@ -612,22 +808,45 @@ inline REAL operator+(const REAL &x, const int &i)
 {
 	if (iRRAM_unlikely(x.value))
 		return x.mp_addition(i);
+	if (iRRAM_unlikely(x.dd()))
+		return x.dd_addition(i);
 	return REAL(REAL::double_pair(x.dp.lower_pos+i,
 	                              x.dp.upper_neg-i));
 }
 
+template <typename X,typename Y>
+inline enable_if_rvalue_op<REAL,X,Y> operator+(X &&x, Y &&y)
+{
+	if (iRRAM_unlikely(x.value||y.value))
+		return std::move(x.mp_conv().mp_eqaddition(y.mp_conv()));
+	if (iRRAM_unlikely(x.dd()||y.dd()))
+		return std::move(x.dd_eqaddition(y));
+	return x + y;
+}
+
+template <typename X,typename Y>
+inline enable_if_lvalue_rvalue_op<REAL,X,Y> operator+(X &&x, Y &&y)
+{
+	return std::move(y) + x;
+}
+
+template <typename X,typename I>
+inline enable_if_rvalue_int_op<REAL,X,I> operator+(X &&x, const I &n)
+{
+	if (iRRAM_unlikely(x.value))
+		return std::move(x.mp_eqaddition(n));
+	return x + n;
+}
+
 inline REAL & REAL::operator+=(const REAL &y)
 {
 	if (iRRAM_unlikely(value||y.value)) {
 		mp_conv().mp_eqaddition(y.mp_conv());
 		return *this;
 	}
-#ifdef _use_SSE2__
-	dp.sse_data = _mm_add_pd(x.dp.sse_data,y.dp.sse_data);
-#else
-	dp.lower_pos+=y.dp.lower_pos;
-	dp.upper_neg+=y.dp.upper_neg;
-#endif
+	if (iRRAM_unlikely(dd()||y.dd()))
+		return dd_eqaddition(y);
+	dp = internal::dp_ops::add(dp, y.dp);
 	return *this;
 }
 
@@ -635,8 +854,9 @@ inline REAL operator-(const REAL& x, const REAL& y)
 {
 	if (iRRAM_unlikely(x.value||y.value))
 		return x.mp_conv().mp_subtraction(y.mp_conv());
-	return REAL(REAL::double_pair(x.dp.lower_pos+y.dp.upper_neg,
-	                              x.dp.upper_neg+y.dp.lower_pos));
+	if (iRRAM_unlikely(x.dd()||y.dd()))
+		return x.dd_subtraction(y);
+	return REAL(internal::dp_ops::sub(x.dp, y.dp));
 }
 
 template <>
@@ -644,6 +864,8 @@ inline REAL operator-(const REAL& x, const int &n)
 {
 	if (iRRAM_unlikely(x.value))
 		return x.mp_subtraction(n);
+	if (iRRAM_unlikely(x.dd()))
+		return x.dd_subtraction(n);
 	return REAL(REAL::double_pair(x.dp.lower_pos-n,
 	                              x.dp.upper_neg+n));
 }
@@ -653,20 +875,76 @@ inline REAL operator-(const int &n, const REAL& x)
 {
 	if (iRRAM_unlikely(x.value))
 		return x.mp_invsubtraction(n);
+	if (iRRAM_unlikely(x.dd()))
+		return x.dd_invsubtraction(n);
 	return REAL(REAL::double_pair(x.dp.upper_neg+n,
 	                              x.dp.lower_pos-n));
 }
 
+template <typename X,typename Y>
+inline enable_if_rvalue_op<REAL,X,Y> operator-(X &&x, Y &&y)
+{
+	if (iRRAM_unlikely(x.value||y.value))
+		return std::move(x.mp_conv().mp_eqsubtraction(y.mp_conv()));
+	if (iRRAM_unlikely(x.dd()||y.dd()))
+		return std::move(x.dd_eqsubtraction(y));
+	return x - y;
+}
+
+template <typename X,typename Y>
+inline enable_if_lvalue_rvalue_op<REAL,X,Y> operator-(X &&x, Y &&y)
+{
+	if (iRRAM_unlikely(x.value||y.value))
+		return std::move(y.mp_conv().mp_eqinvsubtraction(x.mp_conv()));
+	return x - y;
+}
+
+template <typename X,typename I>
+inline enable_if_rvalue_int_op<REAL,X,I> operator-(X &&x, const I &n)
+{
+	if (iRRAM_unlikely(x.value))
+		return std::move(x.mp_eqsubtraction(n));
+	return x - n;
+}
+
+template <typename X,typename I>
+inline enable_if_rvalue_int_op<REAL,X,I> operator-(const I &n, X &&x)
+{
+	if (iRRAM_unlikely(x.value))
+		return std::move(x.mp_eqinvsubtraction(n));
+	return n - x;
+}
+
 inline REAL REAL::operator-() const
 {
 	if (iRRAM_unlikely(value))
 		return mp_invsubtraction(int(0));
-	return REAL(REAL::double_pair(-dp.lower_pos,
-	                              -dp.upper_neg));
+	if (iRRAM_unlikely(dd()))
+		return dd_invsubtraction(0);
+	return REAL(internal::dp_ops::neg(dp));
 }
 
-inline REAL & REAL::operator-=(const REAL &y) { return *this = *this - y; }
-inline REAL & REAL::operator-=(      int   n) { return *this = *this - n; }
+inline REAL & REAL::operator-=(const REAL &y)
+{
+	if (iRRAM_unlikely(value||y.value)) {
+		mp_conv().mp_eqsubtraction(y.mp_conv());
+		return *this;
+	}
+	if (iRRAM_unlikely(dd()||y.dd()))
+		return dd_eqsubtraction(y);
+	dp = internal::dp_ops::sub(dp, y.dp);
+	return *this;
+}
+
+inline REAL & REAL::operator-=(int n)
+{
+	if (iRRAM_unlikely(value))
+		return mp_eqsubtraction(n);
+	if (iRRAM_unlikely(dd()))
+		return dd_eqsubtraction(n);
+	dp = double_pair(dp.lower_pos-n, dp.upper_neg+n);
+	return *this;
+}
 
 // inline double my_fmin(const double& x,const double& y)
 // { return  x<y?x:y ; }
@@ -675,26 +953,9 @@ inline REAL operator*(const REAL & x, const REAL & y)
 {
 	if (iRRAM_unlikely(x.value || y.value))
 		return x.mp_conv().mp_multiplication(y.mp_conv());
-	REAL::double_pair z;
-	if (x.dp.lower_pos >= 0 && y.dp.lower_pos >= 0) {
-		z.lower_pos =   x.dp.lower_pos  * y.dp.lower_pos;
-		z.upper_neg = (-x.dp.upper_neg) * y.dp.upper_neg;
-	} else if (x.dp.upper_neg >= 0 && y.dp.upper_neg >= 0) {
-		z.lower_pos =   x.dp.upper_neg  * y.dp.upper_neg;
-		z.upper_neg = (-x.dp.lower_pos) * y.dp.lower_pos;
-	} else if (x.dp.upper_neg >= 0 && y.dp.lower_pos >= 0) {
-		z.lower_pos = x.dp.lower_pos * (-y.dp.upper_neg);
-		z.upper_neg = x.dp.upper_neg *   y.dp.lower_pos;
-	} else if (x.dp.lower_pos >= 0 && y.dp.upper_neg >= 0) {
-		z.lower_pos = (-x.dp.upper_neg) * y.dp.lower_pos;
-		z.upper_neg =   x.dp.lower_pos  * y.dp.upper_neg;
-	} else {
-		z.lower_pos = fmin((-x.dp.upper_neg) *   y.dp.lower_pos,
-		                     x.dp.lower_pos  * (-y.dp.upper_neg));
-		z.upper_neg = fmin((-x.dp.upper_neg) *   y.dp.upper_neg,
-		                     x.dp.lower_pos  * (-y.dp.lower_pos));
-	}
-	return REAL(z);
+	if (iRRAM_unlikely(x.dd() || y.dd()))
+		return x.dd_multiplication(y);
+	return REAL(internal::dp_ops::mul(x.dp, y.dp));
 }
 
 template <>
@@ -702,29 +963,52 @@ inline REAL operator*(const REAL& x, const int &n)
 {
 	if (iRRAM_unlikely(x.value))
 		return x.mp_multiplication(n);
-	REAL::double_pair z;
-	if (n >= 0) {
-		z.lower_pos = x.dp.lower_pos * n;
-		z.upper_neg = x.dp.upper_neg * n;
-	} else {
-		z.lower_pos = (-x.dp.upper_neg) * n;
-		z.upper_neg = (-x.dp.lower_pos) * n;
-	}
-	return REAL(z);
+	if (iRRAM_unlikely(x.dd()))
+		return x.dd_multiplication(n);
+	return REAL(internal::dp_ops::mul(x.dp, n));
+}
+
+template <typename X,typename Y>
+inline enable_if_rvalue_op<REAL,X,Y> operator*(X &&x, Y &&y)
+{
+	if (iRRAM_unlikely(x.value || y.value))
+		return std::move(x.mp_conv().mp_eqmultiplication(y.mp_conv()));
+	if (iRRAM_unlikely(x.dd()||y.dd()))
+		return std::move(x.dd_eqmultiplication(y));
+	return x * y;
+}
+
+template <typename X,typename Y>
+inline enable_if_lvalue_rvalue_op<REAL,X,Y> operator*(X &&x, Y &&y)
+{
+	return std::move(y) * x;
+}
+
+template <typename X,typename I>
+inline enable_if_rvalue_int_op<REAL,X,I> operator*(X &&x, const I &n)
+{
+	if (iRRAM_unlikely(x.value))
+		return std::move(x.mp_eqmultiplication(n));
+	return x * n;
+}
+
+inline REAL & REAL::operator*=(const REAL &y)
+{
+	if (iRRAM_unlikely(value || y.value))
+		return mp_conv().mp_eqmultiplication(y.mp_conv());
+	if (iRRAM_unlikely(dd() || y.dd()))
+		return dd_eqmultiplication(y);
+	dp = internal::dp_ops::mul(dp, y.dp);
+	return *this;
 }
 
 inline REAL & REAL::operator*=(int n)
 {
 	if (iRRAM_unlikely(value))
-		return *this = mp_multiplication(n);
-	if (n >= 0) {
-		dp.lower_pos *= n;
-		dp.upper_neg *= n;
-	} else {
-		double tmp    = -dp.upper_neg * n;
-		dp.upper_neg  = -dp.lower_pos * n;
-		dp.lower_pos  = tmp;
-	}
+		return mp_eqmultiplication(n);
+	if (iRRAM_unlikely(dd()))
+		return dd_eqmultiplication(n);
+	dp = internal::dp_ops::mul(dp, n);
 	return *this;
 }
 
@@ -732,32 +1016,11 @@ inline REAL operator/(const REAL& x, const REAL& y)
 {
 	if (iRRAM_unlikely(x.value||y.value))
 		return x.mp_conv().mp_division(y.mp_conv());
+	if (iRRAM_unlikely(x.dd()||y.dd()))
+		return x.dd_division(y);
 	REAL::double_pair z;
-	if (y.dp.lower_pos > 0.0) {
-		if (x.dp.lower_pos > 0.0) {
-			z.lower_pos = x.dp.lower_pos/(-y.dp.upper_neg);
-			z.upper_neg = x.dp.upper_neg/  y.dp.lower_pos;
-		} else if (x.dp.upper_neg  > 0.0){
-			z.lower_pos = x.dp.lower_pos/  y.dp.lower_pos;
-			z.upper_neg = x.dp.upper_neg/(-y.dp.upper_neg);
-		} else {
-			z.lower_pos = x.dp.lower_pos/  y.dp.lower_pos;
-			z.upper_neg = x.dp.upper_neg/  y.dp.lower_pos;
-		}
-	} else if (y.dp.upper_neg > 0.0) {
-		if (x.dp.lower_pos > 0.0 ) {
-			z.lower_pos =   x.dp.upper_neg /y.dp.upper_neg;
-			z.upper_neg = (-x.dp.lower_pos)/y.dp.lower_pos;
-		} else if (x.dp.upper_neg  > 0.0){
-			z.lower_pos = (-x.dp.upper_neg)/y.dp.lower_pos;
-			z.upper_neg =   x.dp.lower_pos /y.dp.upper_neg;
-		} else {
-			z.lower_pos = x.dp.upper_neg   /y.dp.upper_neg;
-			z.upper_neg = x.dp.lower_pos   /y.dp.upper_neg;
-		}
-	} else {
+	if (!internal::dp_ops::div(z, x.dp, y.dp))
 		return x.mp_conv().mp_division(y.mp_conv()); // containing zero...
-	}
 	return REAL(z);
 }
 
@@ -766,52 +1029,108 @@ inline REAL operator/(const REAL& x, const int &n)
 {
 	if (iRRAM_unlikely(x.value))
 		return x.mp_division(n);
-	REAL::double_pair z;
-	if (n > 0) {
-#ifdef _use_SSE2__
-		__m128d n_sse = _mm_set_pd1(double(n));
-		n_sse = _mm_div_pd(x.dp.sse_data, n_sse);
-		return REAL(n_sse);
-#else
-		z.lower_pos = x.dp.lower_pos / n,
-		z.upper_neg = x.dp.upper_neg / n;
-#endif
-	} else if (n < 0) {
-		z.lower_pos = (-x.dp.upper_neg) / n;
-		z.upper_neg = (-x.dp.lower_pos) / n;
-	} else {
+	if (iRRAM_unlikely(x.dd()))
+		return x.dd_division(n);
+	if (n == 0)
 		return x.mp_conv().mp_division(0); // containing zero...
-	}
-	return REAL(z);
+	return REAL(internal::dp_ops::div(x.dp, n));
+}
+
+
+template <typename X,typename Y>
+inline enable_if_rvalue_op<REAL,X,Y> operator/(X &&x, Y &&y)
+{
+	if (iRRAM_unlikely(x.value||y.value))
+		return std::move(x.mp_conv().mp_eqdivision(y.mp_conv()));
+	if (iRRAM_unlikely(x.dd()||y.dd()))
+		return std::move(x.dd_eqdivision(y));
+	return x / y;
+}
+
+template <typename X,typename Y>
+inline enable_if_lvalue_rvalue_op<REAL,X,Y> operator/(X &&x, Y &&y)
+{
+	if (iRRAM_unlikely(x.value||y.value))
+		return std::move(y.mp_conv().mp_eqinvdivision(x.mp_conv()));
+	return x / y;
+}
+
+template <typename X,typename I>
+inline enable_if_rvalue_int_op<REAL,X,I> operator/(X &&x, const I &n)
+{
+	if (iRRAM_unlikely(x.value))
+		return std::move(x.mp_eqdivision(n));
+	return x / n;
+}
+
+inline REAL & REAL::operator/=(const REAL &y)
+{
+	if (iRRAM_unlikely(value||y.value))
+		return mp_conv().mp_eqdivision(y.mp_conv());
+	if (iRRAM_unlikely(dd()||y.dd()))
+		return dd_eqdivision(y);
+	double_pair z;
+	if (!internal::dp_ops::div(z, dp, y.dp))
+		return mp_conv().mp_eqdivision(y.mp_conv()); // containing zero...
+	dp = z;
+	return *this;
 }
 
+inline REAL & REAL::operator/=(int n)
+{
+	if (iRRAM_unlikely(value))
+		return mp_eqdivision(n);
+	if (iRRAM_unlikely(dd()))
+		return dd_eqdivision(n);
+	if (n == 0)
+		return mp_conv().mp_eqdivision(0); // containing zero...
+	dp = internal::dp_ops::div(dp, n);
+	return *this;
+}
 
 inline REAL square(const REAL & x)
 {
 	if (iRRAM_unlikely(x.value)) {
 		return x.mp_square();
 	}
-	REAL::double_pair z;
-	if (x.dp.lower_pos >= 0) {
-		z.lower_pos =   x.dp.lower_pos  *   x.dp.lower_pos;
-		z.upper_neg = (-x.dp.upper_neg) *   x.dp.upper_neg;
-	} else if (x.dp.upper_neg >= 0) {
-		z.lower_pos =   x.dp.upper_neg  *   x.dp.upper_neg;
-		z.upper_neg = (-x.dp.lower_pos) *   x.dp.lower_pos;
-	} else if (x.dp.lower_pos < x.dp.upper_neg) {
-		z.lower_pos = 0.0;
-		z.upper_neg =   x.dp.lower_pos  * (-x.dp.lower_pos);
-	} else {
-		z.lower_pos = 0.0;
-		z.upper_neg = (-x.dp.upper_neg) *   x.dp.upper_neg;
-	}
-	return REAL(z);
+	if (iRRAM_unlikely(x.dd()))
+		return x.dd_square();
+	return REAL(internal::dp_ops::square(x.dp));
+}
+
+inline REAL fma(const REAL & x, const REAL & y, const REAL & z)
+{
+	if (iRRAM_unlikely(x.value || y.value || z.value))
+		return x.mp_conv().mp_fma(y.mp_conv(), z.mp_conv());
+	if (iRRAM_unlikely(x.dd() || y.dd() || z.dd()))
+		return x.dd_multiplication(y).dd_addition(z);
+	return REAL(internal::dp_ops::fma(x.dp, y.dp, z.dp));
+}
+
+inline REAL fms(const REAL & x, const REAL & y, const REAL & z)
+{
+	if (iRRAM_unlikely(x.value || y.value || z.value))
+		return x.mp_conv().mp_fms(y.mp_conv(), z.mp_conv());
+	if (iRRAM_unlikely(x.dd() || y.dd() || z.dd()))
+		return x.dd_multiplication(y).dd_subtraction(z);
+	return REAL(internal::dp_ops::fma(x.dp, y.dp, internal::dp_ops::neg(z.dp)));
+}
+
+inline REAL fmma(const REAL & a, const REAL & b, const REAL & c, const REAL & d)
+{
+	if (iRRAM_unlikely(a.value || b.value || c.value || d.value))
+		return a.mp_conv().mp_fmma(b.mp_conv(), c.mp_conv(), d.mp_conv());
+	if (iRRAM_unlikely(a.dd() || b.dd() || c.dd() || d.dd()))
+		return a.dd_multiplication(b).dd_addition(c.dd_multiplication(d));
+	return REAL(internal::dp_ops::fma(a.dp, b.dp, internal::dp_ops::mul(c.dp, d.dp)));
 }
 
 inline LAZY_BOOLEAN operator<(const REAL & x, const REAL & y)
 {
 	if (iRRAM_unlikely(x.value || y.value))
 		return x.mp_conv().mp_less(y.mp_conv());
+	if (iRRAM_unlikely(x.dd() || y.dd()))
+		return x.dd_less(y);
 	if ((-x.dp.upper_neg) <   y.dp.lower_pos )
 		return true;
 	if (  x.dp.lower_pos  > (-y.dp.upper_neg))
@@ -829,13 +1148,9 @@ inline REAL abs(const REAL & x)
 {
 	if (iRRAM_unlikely(x.value))
 		return x.mp_absval();
-	if (x.dp.lower_pos > 0.0)
-		return REAL(REAL::double_pair(x.dp.lower_pos, x.dp.upper_neg));
-	if (x.dp.upper_neg > 0.0)
-		return REAL(REAL::double_pair(x.dp.upper_neg, x.dp.lower_pos));
-	if (x.dp.lower_pos > x.dp.upper_neg)
-		return REAL(REAL::double_pair(0.0, x.dp.upper_neg));
-	return REAL(REAL::double_pair(0.0, x.dp.lower_pos));
+	if (iRRAM_unlikely(x.dd()))
+		return x.dd_absval();
+	return REAL(internal::dp_ops::abs(x.dp));
 }
 
 // inline REAL intervall_join (const REAL& x,const REAL& y){
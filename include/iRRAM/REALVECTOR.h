@@ -0,0 +1,122 @@
+/*
+
+REALVECTOR.h -- header file for the REALVECTOR class of the iRRAM library
+
+This file is part of the iRRAM Library.
+
+The iRRAM Library is free software; you can redistribute it and/or modify
+it under the terms of the GNU Library General Public License as published by
+the Free Software Foundation; either version 2 of the License, or (at your
+option) any later version.
+
+The iRRAM Library is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Library General Public
+License for more details.
+
+You should have received a copy of the GNU Library General Public License
+along with the iRRAM Library; see the file COPYING.LIB.  If not, write to
+the Free Software Foundation, Inc., 59 Temple Place - Suite 330, Boston,
+MA 02111-1307, USA.
+*/
+
+#ifndef iRRAM_REALVECTOR_H
+#define iRRAM_REALVECTOR_H
+
+#include <vector>
+
+#include <iRRAM/REAL.h>
+#include <iRRAM/REALMATRIX.h>
+
+namespace iRRAM {
+
+/*! \ingroup types
+ * \brief A vector of REALs for bulk arithmetic.
+ *
+ * While its elements are double intervals, i.e. in the first \ref Iteration,
+ * the lower and the negated upper bounds are kept in two separate aligned
+ * arrays, on which the arithmetic below runs in SIMD registers. An element
+ * assigned an MP-backed or double-double REAL is kept in a side array instead; operations
+ * involving such elements work element by element on REALs.
+ *
+ * Elements are read by value with operator[] and written with set(). */
+class REALVECTOR
+{
+public:
+	REALVECTOR() noexcept {}
+	/*! \brief n zeroes */
+	explicit REALVECTOR(std::size_t n);
+	REALVECTOR(const std::vector<REAL> &x);
+	/*! \brief The elements of x in row-major order, e.g. a column vector. */
+	explicit REALVECTOR(const REALMATRIX &x);
+	REALVECTOR(const REALVECTOR &x);
+	REALVECTOR(REALVECTOR &&x) noexcept;
+	REALVECTOR & operator=(const REALVECTOR &x);
+	REALVECTOR & operator=(REALVECTOR &&x) noexcept;
+	~REALVECTOR();
+
+	std::size_t size() const noexcept { return n; }
+	REAL operator[](std::size_t i) const;
+	void set(std::size_t i, const REAL &x);
+
+	std::vector<REAL> as_vector() const;
+	/*! \brief The n x 1 matrix of the elements. */
+	REALMATRIX as_REALMATRIX() const;
+
+	friend REALVECTOR operator+(const REALVECTOR &x, const REALVECTOR &y);
+	friend REALVECTOR operator-(const REALVECTOR &x, const REALVECTOR &y);
+	/*! \brief The element-wise product. */
+	friend REALVECTOR operator*(const REALVECTOR &x, const REALVECTOR &y);
+	friend REALVECTOR operator*(const REAL &a, const REALVECTOR &x);
+	friend REALVECTOR operator*(const REALMATRIX &a, const REALVECTOR &x);
+	/*! \brief y += a*x */
+	friend void axpy(const REAL &a, const REALVECTOR &x, REALVECTOR &y);
+	friend REAL dot(const REALVECTOR &x, const REALVECTOR &y);
+	/*! \brief The Euclidean norm, as abs(const std::vector<REAL> &). */
+	friend REAL abs(const REALVECTOR &x);
+
+private:
+	std::size_t n = 0;
+	/* n rounded up to a multiple of the SIMD width, the padding is 0 */
+	std::size_t padded = 0;
+	char *block = nullptr;
+	double *lower = nullptr;     /* the REAL::dp.lower_pos */
+	double *upper_neg = nullptr; /* the REAL::dp.upper_neg */
+	/* empty or n elements, of which `spilled` are not double intervals */
+	std::vector<REAL> mp;
+	std::size_t spilled = 0;
+
+	void allocate(std::size_t n);
+	static REAL interval(double lower, double upper_neg)
+	{
+		return REAL(REAL::double_pair(lower, upper_neg));
+	}
+	static bool dp_only(const REAL &x) { return x.dp_only(); }
+	bool is_mp(std::size_t i) const { return spilled && !mp[i].dp_only(); }
+	/* all elements of both are double intervals */
+	static bool doubles(const REALVECTOR &x, const REALVECTOR &y)
+	{
+		return !x.spilled && !y.spilled;
+	}
+};
+
+/*! \relates REALVECTOR */
+REALVECTOR operator+(const REALVECTOR &x, const REALVECTOR &y);
+/*! \relates REALVECTOR */
+REALVECTOR operator-(const REALVECTOR &x, const REALVECTOR &y);
+/*! \relates REALVECTOR */
+REALVECTOR operator*(const REALVECTOR &x, const REALVECTOR &y);
+/*! \relates REALVECTOR */
+REALVECTOR operator*(const REAL &a, const REALVECTOR &x);
+/*! \relates REALVECTOR */
+REALVECTOR operator*(const REALMATRIX &a, const REALVECTOR &x);
+/*! \relates REALVECTOR */
+void axpy(const REAL &a, const REALVECTOR &x, REALVECTOR &y);
+/*! \relates REALVECTOR */
+REAL dot(const REALVECTOR &x, const REALVECTOR &y);
+/*! \relates REALVECTOR */
+REAL abs(const REALVECTOR &x);
+
+} // namespace iRRAM
+
+#endif
@@ -0,0 +1,423 @@
+/*
+ * REAL_expr.h -- expression templates for REAL arithmetic
+ *
+ * This file is part of the iRRAM Library.
+ *
+ * The iRRAM Library is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Library General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * The iRRAM Library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Library General Public
+ * License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public License
+ * along with the iRRAM Library; see the file COPYING.LIB.  If not, write to
+ * the Free Software Foundation, Inc., 59 Temple Place - Suite 330, Boston,
+ * MA 02111-1307, USA.
+ */
+
+#ifndef iRRAM_REAL_EXPR_H
+#define iRRAM_REAL_EXPR_H
+
+#include <cmath>
+#include <type_traits>
+#include <utility>
+
+#include <iRRAM/REAL.h>
+
+namespace iRRAM {
+
+/*! \brief Opt-in expression templates for REAL arithmetic.
+ *
+ * lazy(x) wraps a REAL. The operators +, -, * and / applied to it and to
+ * further REALs, ints or doubles build a tree, which is evaluated as a whole when
+ * it is converted to REAL:
+ * \code
+ * REAL z = lazy(a) * b + lazy(c) * d - lazy(e) / f;
+ * \endcode
+ * Only subexpressions containing a lazy() operand become part of the tree,
+ * c * d above without lazy() would be an ordinary product.
+ *
+ * If all REALs of the tree are double intervals, i.e. usually in the first
+ * \ref Iteration, the tree is evaluated on the intervals without any
+ * intermediate REAL. Otherwise each node is evaluated by the corresponding
+ * REAL operation, except that products added to or subtracted from another
+ * term are fused into fma(), fms() or fmma(), and that the results of
+ * inner nodes are updated in place by the compound assignments.
+ *
+ * The tree refers to the REALs in it, so it has to be converted within the
+ * full expression creating it; in particular it must not be stored in an
+ * auto variable. */
+namespace expr {
+
+struct access {
+	static bool dp_only(const REAL &x) noexcept { return x.dp_only(); }
+	static REAL make(const internal::double_pair &z) noexcept { return REAL(z); }
+};
+
+struct leaf;
+struct int_leaf;
+struct double_leaf;
+template <typename A> struct neg;
+template <typename L,typename R> struct add;
+template <typename L,typename R> struct sub;
+template <typename L,typename R> struct mul;
+template <typename L,typename R> struct div;
+
+template <typename E> REAL evaluate(const E &e);
+
+template <typename T>
+using if_int = typename std::enable_if<std::is_same<T,int>::value>::type;
+
+template <typename T>
+using if_double = typename std::enable_if<std::is_same<T,double>::value>::type;
+
+/* The operators take the exact node types: they are preferred to those of
+ * REAL, which would need to convert the nodes to REAL first. */
+template <typename E>
+struct node {
+	operator REAL() const { return evaluate(static_cast<const E &>(*this)); }
+
+	friend neg<E> operator-(const E &e) { return neg<E>(e); }
+
+#define iRRAM_EXPR_OPERATOR(op,name)                                          \
+	friend name<E,leaf> operator op(const E &l, const REAL &r)            \
+	{ return name<E,leaf>(l, leaf(r)); }                                  \
+	friend name<leaf,E> operator op(const REAL &l, const E &r)            \
+	{ return name<leaf,E>(leaf(l), r); }                                  \
+	template <typename I,typename = if_int<I>>                            \
+	friend name<E,int_leaf> operator op(const E &l, I r)                  \
+	{ return name<E,int_leaf>(l, int_leaf(r)); }                          \
+	template <typename I,typename = if_int<I>>                            \
+	friend name<int_leaf,E> operator op(I l, const E &r)                  \
+	{ return name<int_leaf,E>(int_leaf(l), r); }                          \
+	template <typename D,typename = if_double<D>>                         \
+	friend name<E,double_leaf> operator op(const E &l, D r)               \
+	{ return name<E,double_leaf>(l, double_leaf(r)); }                    \
+	template <typename D,typename = if_double<D>>                         \
+	friend name<double_leaf,E> operator op(D l, const E &r)               \
+	{ return name<double_leaf,E>(double_leaf(l), r); }
+
+	iRRAM_EXPR_OPERATOR(+,add)
+	iRRAM_EXPR_OPERATOR(-,sub)
+	iRRAM_EXPR_OPERATOR(*,mul)
+	iRRAM_EXPR_OPERATOR(/,div)
+#undef iRRAM_EXPR_OPERATOR
+};
+
+template <typename L,typename R>
+using if_nodes = typename std::enable_if<std::is_base_of<node<L>,L>::value &&
+                                         std::is_base_of<node<R>,R>::value>::type;
+
+template <typename L,typename R,typename = if_nodes<L,R>>
+add<L,R> operator+(const L &l, const R &r) { return add<L,R>(l, r); }
+
+template <typename L,typename R,typename = if_nodes<L,R>>
+sub<L,R> operator-(const L &l, const R &r) { return sub<L,R>(l, r); }
+
+template <typename L,typename R,typename = if_nodes<L,R>>
+mul<L,R> operator*(const L &l, const R &r) { return mul<L,R>(l, r); }
+
+template <typename L,typename R,typename = if_nodes<L,R>>
+div<L,R> operator/(const L &l, const R &r) { return div<L,R>(l, r); }
+
+struct leaf : node<leaf> {
+	const REAL &x;
+	explicit leaf(const REAL &x) : x(x) {}
+};
+
+struct int_leaf {
+	int n;
+	explicit int_leaf(int n) : n(n) {}
+};
+
+/* a double is the exact point interval [d,d] */
+struct double_leaf {
+	double d;
+	explicit double_leaf(double d) : d(d) {}
+};
+
+template <typename A>
+struct neg : node<neg<A>> {
+	A a;
+	explicit neg(const A &a) : a(a) {}
+};
+
+template <typename L,typename R>
+struct binary {
+	L l;
+	R r;
+	binary(const L &l, const R &r) : l(l), r(r) {}
+};
+
+template <typename L,typename R>
+struct add : binary<L,R>, node<add<L,R>> {
+	add(const L &l, const R &r) : binary<L,R>(l, r) {}
+};
+
+template <typename L,typename R>
+struct sub : binary<L,R>, node<sub<L,R>> {
+	sub(const L &l, const R &r) : binary<L,R>(l, r) {}
+};
+
+template <typename L,typename R>
+struct mul : binary<L,R>, node<mul<L,R>> {
+	mul(const L &l, const R &r) : binary<L,R>(l, r) {}
+};
+
+template <typename L,typename R>
+struct div : binary<L,R>, node<div<L,R>> {
+	div(const L &l, const R &r) : binary<L,R>(l, r) {}
+};
+
+/* ------------------------------------------------------------------------
+ * evaluation on double intervals */
+
+typedef internal::double_pair double_pair;
+namespace dp_ops = internal::dp_ops;
+
+/* whether all REALs in the tree are double intervals */
+inline bool dp_leaves(const leaf &e) { return access::dp_only(e.x); }
+inline bool dp_leaves(const int_leaf &) { return true; }
+/* REAL(d) reports non-finite doubles */
+inline bool dp_leaves(const double_leaf &e) { return std::isfinite(e.d); }
+
+template <typename A>
+bool dp_leaves(const neg<A> &e) { return dp_leaves(e.a); }
+
+template <typename L,typename R>
+bool dp_leaves(const binary<L,R> &e) { return dp_leaves(e.l) && dp_leaves(e.r); }
+
+/* ok is cleared for a divisor containing zero, which needs the MP division */
+inline double_pair dp_value(const leaf &e, bool &) { return e.x.dp; }
+
+inline double_pair dp_value(const int_leaf &e, bool &)
+{
+	return double_pair(e.n, -double(e.n));
+}
+
+inline double_pair dp_value(const double_leaf &e, bool &)
+{
+	return double_pair(e.d, -e.d);
+}
+
+template <typename A>
+double_pair dp_value(const neg<A> &e, bool &ok)
+{
+	return dp_ops::neg(dp_value(e.a, ok));
+}
+
+template <typename L,typename R>
+double_pair dp_value(const add<L,R> &e, bool &ok)
+{
+	return dp_ops::add(dp_value(e.l, ok), dp_value(e.r, ok));
+}
+
+template <typename A,typename B,typename R>
+double_pair dp_value(const add<mul<A,B>,R> &e, bool &ok)
+{
+	return dp_ops::fma(dp_value(e.l.l, ok), dp_value(e.l.r, ok),
+	                   dp_value(e.r, ok));
+}
+
+template <typename L,typename A,typename B>
+double_pair dp_value(const add<L,mul<A,B>> &e, bool &ok)
+{
+	return dp_ops::fma(dp_value(e.r.l, ok), dp_value(e.r.r, ok),
+	                   dp_value(e.l, ok));
+}
+
+template <typename A,typename B,typename C,typename D>
+double_pair dp_value(const add<mul<A,B>,mul<C,D>> &e, bool &ok)
+{
+	return dp_ops::fma(dp_value(e.l.l, ok), dp_value(e.l.r, ok),
+	                   dp_value(e.r, ok));
+}
+
+template <typename L,typename R>
+double_pair dp_value(const sub<L,R> &e, bool &ok)
+{
+	return dp_ops::sub(dp_value(e.l, ok), dp_value(e.r, ok));
+}
+
+template <typename A,typename B,typename R>
+double_pair dp_value(const sub<mul<A,B>,R> &e, bool &ok)
+{
+	return dp_ops::fma(dp_value(e.l.l, ok), dp_value(e.l.r, ok),
+	                   dp_ops::neg(dp_value(e.r, ok)));
+}
+
+template <typename L,typename A,typename B>
+double_pair dp_value(const sub<L,mul<A,B>> &e, bool &ok)
+{
+	return dp_ops::fma(dp_ops::neg(dp_value(e.r.l, ok)), dp_value(e.r.r, ok),
+	                   dp_value(e.l, ok));
+}
+
+template <typename A,typename B,typename C,typename D>
+double_pair dp_value(const sub<mul<A,B>,mul<C,D>> &e, bool &ok)
+{
+	return dp_ops::fma(dp_value(e.l.l, ok), dp_value(e.l.r, ok),
+	                   dp_ops::neg(dp_value(e.r, ok)));
+}
+
+template <typename L,typename R>
+double_pair dp_value(const mul<L,R> &e, bool &ok)
+{
+	return dp_ops::mul(dp_value(e.l, ok), dp_value(e.r, ok));
+}
+
+template <typename L>
+double_pair dp_value(const mul<L,int_leaf> &e, bool &ok)
+{
+	return dp_ops::mul(dp_value(e.l, ok), e.r.n);
+}
+
+template <typename R>
+double_pair dp_value(const mul<int_leaf,R> &e, bool &ok)
+{
+	return dp_ops::mul(dp_value(e.r, ok), e.l.n);
+}
+
+template <typename L,typename R>
+double_pair dp_value(const div<L,R> &e, bool &ok)
+{
+	double_pair z;
+	if (!dp_ops::div(z, dp_value(e.l, ok), dp_value(e.r, ok))) {
+		ok = false;
+		return double_pair(0.0, 0.0);
+	}
+	return z;
+}
+
+template <typename L>
+double_pair dp_value(const div<L,int_leaf> &e, bool &ok)
+{
+	if (e.r.n == 0) {
+		ok = false;
+		return double_pair(0.0, 0.0);
+	}
+	return dp_ops::div(dp_value(e.l, ok), e.r.n);
+}
+
+/* ------------------------------------------------------------------------
+ * evaluation by REAL operations */
+
+inline const REAL & value(const leaf &e) { return e.x; }
+inline int          value(const int_leaf &e) { return e.n; }
+inline REAL         value(const double_leaf &e) { return REAL(e.d); }
+
+template <typename A>
+REAL value(const neg<A> &e) { return -value(e.a); }
+
+/* the value of -e, without a negation where it is free */
+inline REAL neg_value(const leaf &e) { return -e.x; }
+inline int  neg_value(const int_leaf &e) { return -e.n; }
+inline REAL neg_value(const double_leaf &e) { return REAL(-e.d); }
+
+template <typename A>
+auto neg_value(const neg<A> &e) -> decltype(value(e.a)) { return value(e.a); }
+
+template <typename E>
+REAL neg_value(const E &e) { return -value(e); }
+
+/* x+y, x-y and x*y, in place where x or y is a temporary */
+inline REAL sum(const REAL &x, const REAL &y) { return x + y; }
+inline REAL sum(REAL &&x, const REAL &y) { x += y; return std::move(x); }
+inline REAL sum(const REAL &x, REAL &&y) { y += x; return std::move(y); }
+inline REAL sum(REAL &&x, REAL &&y) { x += y; return std::move(x); }
+inline REAL sum(const REAL &x, int n) { return x + n; }
+inline REAL sum(int n, const REAL &y) { return y + n; }
+
+inline REAL difference(const REAL &x, const REAL &y) { return x - y; }
+inline REAL difference(REAL &&x, const REAL &y) { x -= y; return std::move(x); }
+inline REAL difference(const REAL &x, int n) { return x - n; }
+inline REAL difference(REAL &&x, int n) { x -= n; return std::move(x); }
+inline REAL difference(int n, const REAL &y) { return n - y; }
+
+inline REAL product(const REAL &x, const REAL &y) { return x * y; }
+inline REAL product(REAL &&x, const REAL &y) { x *= y; return std::move(x); }
+inline REAL product(const REAL &x, REAL &&y) { y *= x; return std::move(y); }
+inline REAL product(REAL &&x, REAL &&y) { x *= y; return std::move(x); }
+inline REAL product(const REAL &x, int n) { return x * n; }
+inline REAL product(REAL &&x, int n) { x *= n; return std::move(x); }
+inline REAL product(int n, const REAL &y) { return y * n; }
+inline REAL product(int n, REAL &&y) { y *= n; return std::move(y); }
+
+inline REAL quotient(const REAL &x, const REAL &y) { return x / y; }
+inline REAL quotient(const REAL &x, int n) { return x / n; }
+inline REAL quotient(int n, const REAL &y) { return n / y; }
+
+template <typename L,typename R>
+REAL value(const add<L,R> &e) { return sum(value(e.l), value(e.r)); }
+
+template <typename A,typename B,typename R>
+REAL value(const add<mul<A,B>,R> &e)
+{
+	return iRRAM::fma(value(e.l.l), value(e.l.r), value(e.r));
+}
+
+template <typename L,typename A,typename B>
+REAL value(const add<L,mul<A,B>> &e)
+{
+	return iRRAM::fma(value(e.r.l), value(e.r.r), value(e.l));
+}
+
+template <typename A,typename B,typename C,typename D>
+REAL value(const add<mul<A,B>,mul<C,D>> &e)
+{
+	return iRRAM::fmma(value(e.l.l), value(e.l.r),
+	                   value(e.r.l), value(e.r.r));
+}
+
+template <typename L,typename R>
+REAL value(const sub<L,R> &e) { return difference(value(e.l), value(e.r)); }
+
+template <typename A,typename B,typename R>
+REAL value(const sub<mul<A,B>,R> &e)
+{
+	return iRRAM::fms(value(e.l.l), value(e.l.r), value(e.r));
+}
+
+template <typename L,typename A,typename B>
+REAL value(const sub<L,mul<A,B>> &e)
+{
+	return iRRAM::fma(neg_value(e.r.l), value(e.r.r), value(e.l));
+}
+
+template <typename A,typename B,typename C,typename D>
+REAL value(const sub<mul<A,B>,mul<C,D>> &e)
+{
+	return iRRAM::fmma(value(e.l.l), value(e.l.r),
+	                   neg_value(e.r.l), value(e.r.r));
+}
+
+template <typename L,typename R>
+REAL value(const mul<L,R> &e) { return product(value(e.l), value(e.r)); }
+
+template <typename L,typename R>
+REAL value(const div<L,R> &e) { return quotient(value(e.l), value(e.r)); }
+
+template <typename E>
+REAL evaluate(const E &e)
+{
+	if (dp_leaves(e)) {
+		bool ok = true;
+		double_pair z = dp_value(e, ok);
+		if (ok)
+			return access::make(z);
+	}
+	return value(e);
+}
+
+} // namespace expr
+
+/*! \brief Starts an expression evaluated as a whole, see \ref expr */
+inline expr::leaf lazy(const REAL &x) { return expr::leaf(x); }
+
+} // namespace iRRAM
+
+#endif /* iRRAM_REAL_EXPR_H */
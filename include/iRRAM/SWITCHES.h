@@ -50,8 +50,6 @@ MA 02111-1307, USA.
 
 namespace iRRAM {
 
-extern const int *const iRRAM_prec_array;
-extern const int iRRAM_prec_steps;
 
 
 /*! \addtogroup switches
@@ -67,8 +65,16 @@ extern const int iRRAM_prec_steps;
  * obsoletes `continous_begin()`, `continous_end()` */
 struct single_valued
 {
-	inline  single_valued() noexcept { state->ACTUAL_STACK.inlimit++; }
-	inline ~single_valued() noexcept { --state->ACTUAL_STACK.inlimit; }
+	inline single_valued() noexcept
+	{
+		state->ACTUAL_STACK.inlimit++;
+		set_precision_levels(*state);
+	}
+	inline ~single_valued() noexcept
+	{
+		--state->ACTUAL_STACK.inlimit;
+		set_precision_levels(*state);
+	}
 };
 
 
@@ -110,8 +116,8 @@ protected:
 		if (n<1) n=1;
 		if (iRRAM_prec_steps <= n) n = iRRAM_prec_steps-1;
 		state->ACTUAL_STACK.prec_step = n;
-		state->ACTUAL_STACK.actual_prec = iRRAM_prec_array[state->ACTUAL_STACK.prec_step];
-		state->highlevel = (state->ACTUAL_STACK.prec_step > iRRAM_DEFAULT_PREC_START);
+		state->ACTUAL_STACK.actual_prec = state->prec_array[state->ACTUAL_STACK.prec_step];
+		set_precision_levels(*state);
 	}
 
 public:
@@ -127,7 +133,7 @@ public:
 	stiff operator=(const stiff &) = delete;
 
 	int saved_step() const noexcept { return saved; }
-	int saved_prec(int delta_step = 0) const noexcept { return iRRAM_prec_array[saved + delta_step]; }
+	int saved_prec(int delta_step = 0) const noexcept { return state->prec_array[saved + delta_step]; }
 
 	void inc_step(int n) const noexcept
 	{
@@ -154,6 +160,89 @@ struct relaxed : public stiff {
 /*! \brief Combination of \ref stiff and single_valued. */
 struct limit_computation : public stiff, single_valued { using stiff::stiff; };
 
+/*! \brief Use another precision ladder.
+ *
+ * `use_ladder code(l)` -> the precision steps refer to the precision_ladder
+ * `l` until the end of the scope, e.g.
+ *
+ *     static const precision_ladder fine = precision_ladder::linear(-50, -10);
+ *     use_ladder code(fine);
+ *     exec(compute);
+ *
+ * `l` has to outlive the switch. The current precision step is kept, its
+ * precision is taken from the new ladder. */
+class use_ladder
+{
+	const int *saved;
+	static inline void set(const int *prec_array) noexcept
+	{
+		ITERATION_DATA &actual_stack = state->ACTUAL_STACK;
+		state->prec_array = prec_array;
+		if (actual_stack.prec_step >= 1) /* inside of exec() */
+			actual_stack.actual_prec = prec_array[actual_stack.prec_step];
+	}
+public:
+	inline explicit use_ladder(const precision_ladder &l) noexcept
+	: saved(state->prec_array)
+	{
+		set(l.data());
+	}
+	inline ~use_ladder() noexcept { set(saved); }
+	use_ladder(const use_ladder &) = delete;
+	use_ladder & operator=(const use_ladder &) = delete;
+};
+
+/*! \brief Signal reiterations without exceptions.
+ *
+ * `deferred_reiteration code` -> bound(), size(), choose(), approx() and the
+ * conversion of a LAZY_BOOLEAN to bool do not throw when the precision is not
+ * sufficient, but mark the current iteration as failed and return an
+ * arbitrary result. The computation continues and is unwound once at the
+ * end of the current limit's function or of exec(), at the latest after
+ * \ref iRRAM_DEFER_REITERATION_LIMIT further failures.
+ * Reading input also unwinds a pending reiteration first.
+ *
+ * `deferred_reiteration code(false)` -> switch back to exceptions.
+ *
+ * The default is given by \ref iRRAM_DEFAULT_DEFER_REITERATION.
+ * Note that code depending on the results of those operations, e.g.
+ * indexing by choose(), has to cope with arbitrary values in this mode. */
+class deferred_reiteration
+{
+	bool saved;
+public:
+	inline explicit deferred_reiteration(bool on = true) noexcept
+	: saved(state->defer_reiteration)
+	{
+		state->defer_reiteration = on;
+	}
+	inline ~deferred_reiteration() noexcept { state->defer_reiteration = saved; }
+	deferred_reiteration(const deferred_reiteration &) = delete;
+	deferred_reiteration & operator=(const deferred_reiteration &) = delete;
+};
+
+/*! \brief Limit the size of the multi-valued cache to `bytes`.
+ *
+ * When the cache of an exec() grows beyond the limit, a warning is printed
+ * once or, if `error` is set, iRRAM_Numerical_Exception(iRRAM_cache_overflow)
+ * is thrown. A limit of 0 means unlimited. See cache_statistics() for the
+ * current size. */
+class cache_limit
+{
+	std::size_t saved;
+	bool saved_error;
+	static void set(std::size_t bytes, bool error);
+public:
+	inline explicit cache_limit(std::size_t bytes, bool error = false)
+	: saved(state->cache_limit), saved_error(state->cache_limit_error)
+	{
+		set(bytes, error);
+	}
+	inline ~cache_limit() { set(saved, saved_error); }
+	cache_limit(const cache_limit &) = delete;
+	cache_limit & operator=(const cache_limit &) = delete;
+};
+
 //! @} /* end group switches */
 
 } // namespace iRRAM
@@ -25,155 +25,430 @@ MA 02111-1307, USA.
 #ifndef iRRAM_CACHE_H
 #define iRRAM_CACHE_H
 
+#include <cassert>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <algorithm>
 #include <string>
+#include <iosfwd>
+#include <typeinfo>
 #include <vector>
 
+#include <iRRAM/core.h>
+
 namespace iRRAM {
 
-template <typename T,void (*clearfct)(T &)>
-struct wrap_type {
-	T v;
+/* The results of multi-valued operations are recorded on a tape in the order
+ * they are computed and replayed from its start in each reiteration. A record
+ * is a header followed by the encoded value, padded to keep the next header
+ * aligned. MPFR and GMP numbers are stored with their limbs, and are decoded
+ * as read-only views into the tape that stay valid until the next put().
+ *
+ * As the records are replayed in order, the computation of a result between
+ * a failed get_cached() and its put_cached() has to be single_valued. */
+
+namespace internal {
+
+struct tape_header {
+	uint32_t tag;
+	uint32_t size; /* bytes of the value, without padding */
+};
+
+enum : std::size_t { tape_align = 8 };
 
-	wrap_type() noexcept(noexcept(T())) : v(T()) {}
+constexpr std::size_t tape_pad(std::size_t n)
+{
+	return (n + tape_align - 1) & ~std::size_t(tape_align - 1);
+}
+
+static_assert(sizeof(tape_header) % tape_align == 0, "misaligned tape record");
 
-	wrap_type(const T &v) noexcept(noexcept(T(v))) : v(v) {}
+}
 
-	wrap_type(wrap_type &&o) noexcept(noexcept(std::swap(v, o.v)))
-	: wrap_type()
-	{ using std::swap; swap(v, o.v); }
+/*! \brief Hooks to record values of a user type as one multi-valued result.
+ *
+ * Specialize it for T with the members
+ *
+ *     static void save(cache_writer &w, const T &x);
+ *     static void load(cache_reader &r, T &x);
+ *
+ * which write and read the parts of `x` in the same order, e.g.
+ *
+ *     template <> struct cache_traits<choice> {
+ *         static void save(cache_writer &w, const choice &c)
+ *         { w.write(c.index); w.write(c.bounds); }
+ *         static void load(cache_reader &r, choice &c)
+ *         { r.read(c.index); r.read(c.bounds); }
+ *     };
+ *
+ * Parts can be of any type put_cached() accepts, including other user types
+ * and std::vector, for which cache_traits are predefined. */
+template <typename T, typename = void> struct cache_traits;
 
-	~wrap_type() noexcept { clearfct(v); }
+template <typename T, typename = void> struct tape_codec_user {};
 
-	wrap_type & operator=(const T &_v) noexcept(noexcept(const_cast<T &>(_v)=_v))
-	{ v = _v; return *this; }
+/* How a type is stored on the tape: a unique tag(), the size() of the
+ * encoded value, encode() writing that many bytes and decode() reading
+ * them. Types with cache_traits are stored as a sequence of records. */
+template <typename T> struct tape_codec : tape_codec_user<T> {};
 
-	wrap_type & operator=(wrap_type o) noexcept(noexcept(std::swap(v, o.v)))
-	{ using std::swap; swap(v, o.v); return *this; }
+template <typename T, uint32_t Tag>
+struct tape_codec_raw {
+	static_assert(alignof(T) <= internal::tape_align, "alignment too large");
+	static constexpr uint32_t tag() noexcept { return Tag; }
+	static std::size_t size(const T &) noexcept { return sizeof(T); }
+	static void encode(void *p, const T &x) noexcept { memcpy(p, &x, sizeof(T)); }
+	static void decode(const void *p, std::size_t, T &x) noexcept { memcpy(&x, p, sizeof(T)); }
+};
 
-	operator T() const noexcept { return v; }
+template <> struct tape_codec<bool> : tape_codec_raw<bool,1> {};
+template <> struct tape_codec<short> : tape_codec_raw<short,2> {};
+template <> struct tape_codec<unsigned short> : tape_codec_raw<unsigned short,3> {};
+template <> struct tape_codec<int> : tape_codec_raw<int,4> {};
+template <> struct tape_codec<unsigned int> : tape_codec_raw<unsigned int,5> {};
+template <> struct tape_codec<long> : tape_codec_raw<long,6> {};
+template <> struct tape_codec<unsigned long> : tape_codec_raw<unsigned long,7> {};
+template <> struct tape_codec<long long> : tape_codec_raw<long long,8> {};
+template <> struct tape_codec<unsigned long long> : tape_codec_raw<unsigned long long,9> {};
+template <> struct tape_codec<float> : tape_codec_raw<float,10> {};
+template <> struct tape_codec<double> : tape_codec_raw<double,11> {};
+template <> struct tape_codec<void *> : tape_codec_raw<void *,12> {};
+template <> struct tape_codec<std::ostream *> : tape_codec_raw<std::ostream *,16> {};
+template <> struct tape_codec<std::istream *> : tape_codec_raw<std::istream *,17> {};
+
+template <> struct tape_codec<MP_type> {
+	static constexpr uint32_t tag() noexcept { return 13; }
+	static std::size_t limbs(const MP_type &z) noexcept
+	{
+		return mpfr_regular_p(z) ? mpfr_custom_get_size(mpfr_get_prec(z)) : 0;
+	}
+	static std::size_t size(const MP_type &z) noexcept
+	{
+		return sizeof(__mpfr_struct) + limbs(z);
+	}
+	static void encode(void *p, const MP_type &z) noexcept
+	{
+		memcpy(p, z, sizeof(__mpfr_struct));
+		memcpy(static_cast<__mpfr_struct *>(p) + 1,
+		       mpfr_custom_get_significand(z), limbs(z));
+	}
+	static void decode(const void *p, std::size_t, MP_type &z) noexcept
+	{
+		z = static_cast<__mpfr_struct *>(const_cast<void *>(p));
+		mpfr_custom_move(z, z + 1);
+	}
 };
 
-template <typename T> struct get_type {
-	typedef T type;
+template <> struct tape_codec<MP_int_type> {
+	static constexpr uint32_t tag() noexcept { return 14; }
+	static std::size_t size(const MP_int_type &z) noexcept
+	{
+		return sizeof(__mpz_struct) + mpz_size(z) * sizeof(mp_limb_t);
+	}
+	static void encode(void *p, const MP_int_type &z) noexcept
+	{
+		memcpy(p, z, sizeof(__mpz_struct));
+		memcpy(static_cast<__mpz_struct *>(p) + 1, mpz_limbs_read(z),
+		       mpz_size(z) * sizeof(mp_limb_t));
+	}
+	static void decode(const void *p, std::size_t, MP_int_type &z) noexcept
+	{
+		z = static_cast<__mpz_struct *>(const_cast<void *>(p));
+		mpz_roinit_n(z, reinterpret_cast<mp_limb_t *>(z + 1), z->_mp_size);
+	}
 };
 
-template <> struct get_type<bool> {
-	static void clear(bool &){}
-	typedef wrap_type<bool,clear> type;
+template <> struct tape_codec<std::string> {
+	static constexpr uint32_t tag() noexcept { return 15; }
+	static std::size_t size(const std::string &s) noexcept { return s.size(); }
+	static void encode(void *p, const std::string &s) noexcept
+	{
+		memcpy(p, s.data(), s.size());
+	}
+	static void decode(const void *p, std::size_t n, std::string &s)
+	{
+		s.assign(static_cast<const char *>(p), n);
+	}
 };
 
-template <> struct get_type<MP_type> {
-	static void clear(MP_type &t){ if(t) MP_clear(t); }
-	typedef wrap_type<MP_type,clear> type;
+class DYADIC;
+class INTEGER;
+
+/* exponent, precision and sign, then the limbs without the zero low ones */
+template <> struct tape_codec<DYADIC> {
+	static constexpr uint32_t tag() noexcept { return 18; }
+	static std::size_t size(const DYADIC &x) noexcept;
+	static void encode(void *p, const DYADIC &x) noexcept;
+	static void decode(const void *p, std::size_t n, DYADIC &x);
 };
 
-template <> struct get_type<MP_int_type> {
-	static void clear(MP_int_type &t){ if (t) MP_int_clear(t); }
-	typedef wrap_type<MP_int_type,clear> type;
+/* signed number of limbs, then the limbs */
+template <> struct tape_codec<INTEGER> {
+	static constexpr uint32_t tag() noexcept { return 19; }
+	static std::size_t size(const INTEGER &x) noexcept;
+	static void encode(void *p, const INTEGER &x) noexcept;
+	static void decode(const void *p, std::size_t n, INTEGER &x);
 };
 
+template <typename T, typename = void> struct is_cacheable : std::false_type {};
+template <typename T>
+struct is_cacheable<T,decltype(void(tape_codec<T>::tag()))> : std::true_type {};
 
-struct cache_type
-{
-	/* never invoked; just to silence compiler */
-	virtual ~cache_type() noexcept = default;
-	virtual void clear() = 0;
-	virtual void rewind() noexcept = 0;
+/*! \brief Writes the parts of a value for cache_traits<T>::save(). */
+class cache_writer {
+	char *p;           /* nullptr: only count the bytes */
+	std::size_t n = 0;
+public:
+	explicit cache_writer(char *p) noexcept : p(p) {}
+
+	template <typename T>
+	void write(const T &x)
+	{
+		static_assert(is_cacheable<T>::value, "type without cache_traits");
+		std::size_t s = tape_codec<T>::size(x);
+		if (p) {
+			internal::tape_header h = { tape_codec<T>::tag(), uint32_t(s) };
+			memcpy(p + n, &h, sizeof(h));
+			tape_codec<T>::encode(p + n + sizeof(h), x);
+		}
+		n += sizeof(internal::tape_header) + internal::tape_pad(s);
+	}
+
+	std::size_t size() const noexcept { return n; }
 };
 
-struct cachelist
-{
-	cache_type * id[50];
+/*! \brief Reads the parts of a value for cache_traits<T>::load(). */
+class cache_reader {
+	const char *p;
+	std::size_t n;
+public:
+	cache_reader(const void *p, std::size_t n) noexcept
+	: p(static_cast<const char *>(p)), n(n) {}
+
+	template <typename T>
+	void read(T &x)
+	{
+		internal::tape_header h;
+		assert(n >= sizeof(h));
+		memcpy(&h, p, sizeof(h));
+		assert(h.tag == tape_codec<T>::tag());
+		tape_codec<T>::decode(p + sizeof(h), h.size, x);
+		std::size_t s = sizeof(h) + internal::tape_pad(h.size);
+		p += s;
+		n -= s;
+	}
+};
+
+namespace internal {
+/* tags of user types have the highest bit set */
+uint32_t tape_user_tag(const std::type_info &t) noexcept;
+}
+
+template <typename T>
+struct tape_codec_user<T,decltype(void(&cache_traits<T>::save))> {
+	static uint32_t tag() noexcept
+	{
+		static const uint32_t t = internal::tape_user_tag(typeid(T));
+		return t;
+	}
+	static std::size_t size(const T &x)
+	{
+		cache_writer w(nullptr);
+		cache_traits<T>::save(w, x);
+		return w.size();
+	}
+	static void encode(void *p, const T &x)
+	{
+		cache_writer w(static_cast<char *>(p));
+		cache_traits<T>::save(w, x);
+	}
+	static void decode(const void *p, std::size_t n, T &x)
+	{
+		cache_reader r(p, n);
+		cache_traits<T>::load(r, x);
+	}
 };
 
-template <class DATA>
-class cache : public cache_type
+template <typename T, typename A>
+struct cache_traits<std::vector<T,A>,std::enable_if_t<is_cacheable<T>::value>> {
+	static void save(cache_writer &w, const std::vector<T,A> &v)
+	{
+		w.write((unsigned long long)v.size());
+		for (const T &x : v)
+			w.write(x);
+	}
+	static void load(cache_reader &r, std::vector<T,A> &v)
+	{
+		unsigned long long n;
+		r.read(n);
+		v.resize(n);
+		for (unsigned long long i = 0; i < n; i++) {
+			T x;
+			r.read(x);
+			v[i] = x;
+		}
+	}
+};
+
+/* the multi-valued cache of an exec() */
+class mv_cache final
 {
-	std::vector<typename get_type<DATA>::type> data;
-	unsigned int current = 0;
-	bool active = false;
+	char *tape = nullptr;
+	std::size_t len = 0;  /* end of the recorded data */
+	std::size_t cap = 0;
+	std::size_t cur = 0;  /* next record to replay */
+	std::size_t last = 0; /* record put or replayed last */
+
+	/* indexed by tag for the built-in types, then the user types */
+	std::vector<cache_type_stats> types;
+	std::size_t max_len = 0;
+	std::size_t limit = 0;
+	std::size_t check = 0; /* tape size above which put() calls grow() */
+	bool limit_error = false;
+	bool limit_hit = false;
+
+	void grow(std::size_t n);
+	void reserve(std::size_t n);
+	void recount() noexcept;
+	cache_type_stats & user_stats(uint32_t tag);
+
+	enum : uint32_t { builtin_tags = 32 };
+
+	cache_type_stats & stats(uint32_t tag)
+	{
+		return tag < builtin_tags ? types[tag] : user_stats(tag);
+	}
+
+	void account(uint32_t tag, std::size_t bytes)
+	{
+		cache_type_stats &s = stats(tag);
+		s.entries++;
+		s.bytes += bytes;
+		s.max_entries = std::max(s.max_entries, s.entries);
+		s.max_bytes = std::max(s.max_bytes, s.bytes);
+		max_len = std::max(max_len, len);
+	}
 
-	void activate()
+	internal::tape_header * header(std::size_t pos) const noexcept
 	{
-		data.clear();
-		active = true;
-		state->cache_active->id[state->max_active++] = this;
-		current = 0;
+		return reinterpret_cast<internal::tape_header *>(tape + pos);
 	}
 
 public:
-	void put(const DATA & x)
+	mv_cache();
+	~mv_cache();
+	mv_cache(const mv_cache &) = delete;
+	mv_cache & operator=(const mv_cache &) = delete;
+
+	template <typename T>
+	void put(const T & x)
 	{
-		if (iRRAM_unlikely(!active))
-			activate();
-		data.emplace_back(x);
-		current++;
+		static_assert(is_cacheable<T>::value, "type without cache_traits");
+		std::size_t n = tape_codec<T>::size(x);
+		std::size_t end = len + sizeof(internal::tape_header) + internal::tape_pad(n);
+		if (iRRAM_unlikely(end > check))
+			grow(end);
+		internal::tape_header *h = header(len);
+		h->tag = tape_codec<T>::tag();
+		h->size = n;
+		tape_codec<T>::encode(h + 1, x);
+		last = len;
+		cur = len = end;
+		account(h->tag, end - last);
 	}
 
-	bool get(DATA & x) noexcept(noexcept(x=x))
+	template <typename T>
+	bool get(T & x)
 	{
-		if (current >= data.size())
+		if (cur >= len)
 			return false;
-		x = data[current++];
+		const internal::tape_header *h = header(cur);
+		if (iRRAM_unlikely(h->tag != tape_codec<T>::tag())) {
+			/* the computation took another path than recorded,
+			 * nothing from here on can be replayed */
+			len = cur;
+			recount();
+			return false;
+		}
+		stats(h->tag).hits++;
+		tape_codec<T>::decode(h + 1, h->size, x);
+		last = cur;
+		cur += sizeof(internal::tape_header) + internal::tape_pad(h->size);
 		return true;
 	}
 
-	void modify(const DATA & x) noexcept(noexcept(const_cast<DATA &>(x)=x))
+	/* replace the record put or replayed last */
+	template <typename T>
+	void modify(const T & x)
 	{
-		data[current - 1] = x;
+		internal::tape_header *h = header(last);
+		assert(last < len && h->tag == tape_codec<T>::tag());
+		if (tape_codec<T>::size(x) == h->size) {
+			tape_codec<T>::encode(h + 1, x);
+		} else {
+			/* other sizes only for the last record on the tape */
+			assert(cur == len);
+			cur = len = last;
+			recount();
+			put(x);
+		}
 	}
 
-	void rewind() noexcept { current = 0; }
+	void rewind() noexcept { cur = 0; }
+	void clear() noexcept { len = cur = last = 0; recount(); }
+	/* exchanges the records, statistics and limits with c */
+	void swap(mv_cache &c) noexcept;
+
+	std::size_t position() const noexcept { return cur; }
+	void seek(std::size_t pos) noexcept { cur = pos; }
 
-	void clear()
+	/* bytes recorded, allocated */
+	std::size_t size() const noexcept { return len; }
+	std::size_t capacity() const noexcept { return cap; }
+	const char * data() const noexcept { return tape; }
+
+	/* at more than `bytes` (0: unlimited), warn once or throw
+	 * iRRAM_Numerical_Exception(iRRAM_cache_overflow) */
+	void set_limit(std::size_t bytes, bool error) noexcept;
+	void statistics(cache_stats &s) const;
+
+	/* replace the records by the `n` bytes at `p`, as returned by data();
+	 * false if they are not a sequence of valid records */
+	bool assign(const char *p, std::size_t n);
+
+	/* whether some record has the tag of T */
+	template <typename T>
+	bool contains() const noexcept
 	{
-		data.clear();
-		active = false;
-		current = 0;
+		for (std::size_t pos = 0; pos < len;
+		     pos += sizeof(internal::tape_header) + internal::tape_pad(header(pos)->size))
+			if (header(pos)->tag == tape_codec<T>::tag())
+				return true;
+		return false;
 	}
 };
 
-template <typename T> struct is_cacheable : std::false_type {};
-template <> struct is_cacheable<bool> : std::true_type {};
-template <> struct is_cacheable<short> : std::true_type {};
-template <> struct is_cacheable<unsigned short> : std::true_type {};
-template <> struct is_cacheable<int> : std::true_type {};
-template <> struct is_cacheable<unsigned int> : std::true_type {};
-template <> struct is_cacheable<long> : std::true_type {};
-template <> struct is_cacheable<unsigned long> : std::true_type {};
-template <> struct is_cacheable<long long> : std::true_type {};
-template <> struct is_cacheable<unsigned long long> : std::true_type {};
-template <> struct is_cacheable<float> : std::true_type {};
-template <> struct is_cacheable<double> : std::true_type {};
-template <> struct is_cacheable<void *> : std::true_type {};
-template <> struct is_cacheable<MP_type> : std::true_type {};
-template <> struct is_cacheable<MP_int_type> : std::true_type {};
-template <> struct is_cacheable<std::string> : std::true_type {};
-template <> struct is_cacheable<std::ostream *> : std::true_type {};
-template <> struct is_cacheable<std::istream *> : std::true_type {};
-
-struct mv_cache final
-: cache<bool>
-, cache<short> // unused
-, cache<unsigned short> // unused
-, cache<int>
-, cache<unsigned int> // unused
-, cache<long> // unusused
-, cache<unsigned long> // unused
-, cache<long long> // unused
-, cache<unsigned long long> // unused
-, cache<float> // unused
-, cache<double> // unused
-, cache<void*> // unused
-, cache<MP_type>
-, cache<MP_int_type>
-, cache<std::string>
-, cache<std::ostream*>
-, cache<std::istream*>
+template <typename T>
+inline bool get_cached(T &t, const state_t &st)
 {
-	mv_cache();
-	~mv_cache();
-};
+	return st.ACTUAL_STACK.inlimit == 0 && st.cache_address->get(t);
+}
+
+template <typename T>
+inline void put_cached(const T &t, const state_t &st)
+{
+	/* decisions taken on poisoned values must not be replayed */
+	if (st.ACTUAL_STACK.inlimit == 0 && !st.reiterate_pending)
+		st.cache_address->put(t);
+}
+
+template <typename T>
+inline void modify_cached(const T &t, const state_t &st)
+{
+	if (st.ACTUAL_STACK.inlimit == 0 && !st.reiterate_pending)
+		st.cache_address->modify(t);
+}
 
 } // namespace iRRAM
 
@@ -0,0 +1,181 @@
+/*
+
+iRRAM/checkpoint.h -- resuming reiterations from settled intermediate states
+
+This file is part of the iRRAM Library.
+
+The iRRAM Library is free software; you can redistribute it and/or modify
+it under the terms of the GNU Library General Public License as published by
+the Free Software Foundation; either version 2 of the License, or (at your
+option) any later version.
+
+The iRRAM Library is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Library General Public
+License for more details.
+
+You should have received a copy of the GNU Library General Public License
+along with the iRRAM Library; see the file COPYING.LIB.  If not, write to
+the Free Software Foundation, Inc., 59 Temple Place - Suite 330, Boston,
+MA 02111-1307, USA.
+*/
+
+/*! \defgroup checkpoints Checkpoints
+ * \brief Restart a reiteration from a settled point instead of from the top.
+ *
+ * On a reiteration, exec() normally reruns the whole user function, replaying
+ * all multi-valued decisions from the cache. With checkpoints the user
+ * function records the variables describing its progress, e.g. the state of
+ * an orbit after a number of steps, and asks for them back on entry:
+ *
+ *     REAL x = x0;
+ *     int i = 0;
+ *     restore_checkpoint(x, i);
+ *     for (; i < n; i++) {
+ *         x = approx(f(x), p);   // settled: exact DYADIC
+ *         checkpoint(x, i + 1);
+ *     }
+ *
+ * restore_checkpoint() picks the newest checkpoint of an earlier iteration
+ * whose values are still good enough for the current precision, assigns them
+ * and positions the caches of multi-valued operations and the output counters
+ * right after that checkpoint. The computation then continues from there.
+ * A REAL is considered good enough if its error is smaller than
+ * 2^actual_prec of the current iteration, so the typical candidates are
+ * values rounded with approx() or obtained from discrete data.
+ *
+ * Checkpoints are only taken and restored at the top level of exec(), i.e.
+ * not inside limits or single_valued sections, and the sequence of
+ * checkpoint() calls must be the same in every iteration up to the point
+ * where it failed (which is the case for any deterministic program).
+ *
+ * @{ */
+
+#ifndef iRRAM_CHECKPOINT_H
+#define iRRAM_CHECKPOINT_H
+
+#include <memory>
+#include <vector>
+#include <tuple>
+#include <utility>
+#include <initializer_list>
+
+#include <iRRAM/REAL.h>
+#include <iRRAM/cache.h>
+
+namespace iRRAM {
+
+/*! \brief Whether a recorded value may be reused at the current precision.
+ *
+ * Discrete values are always usable. Overload for own types if needed. */
+template <typename T>
+inline bool checkpoint_usable(const T &) { return true; }
+
+inline bool checkpoint_usable(const REAL &x)
+{
+	sizetype err;
+	x.geterror(err);
+	return sizetype_less(err, sizetype_power2(actual_stack().actual_prec));
+}
+
+template <typename T>
+inline bool checkpoint_usable(const std::vector<T> &v)
+{
+	for (const T &x : v)
+		if (!checkpoint_usable(x))
+			return false;
+	return true;
+}
+
+/*! @} */
+
+namespace internal {
+
+struct checkpoint_slot {
+	virtual ~checkpoint_slot() = default;
+	virtual bool usable() const = 0;
+};
+
+template <typename... Vars>
+struct checkpoint_values final : checkpoint_slot {
+	std::tuple<Vars...> v;
+
+	explicit checkpoint_values(const Vars &... vars) : v(vars...) {}
+
+	bool usable() const { return all_usable(std::index_sequence_for<Vars...>{}); }
+
+	template <std::size_t... I>
+	bool all_usable(std::index_sequence<I...>) const
+	{
+		bool r = true;
+		(void)std::initializer_list<int>{ (r = r && checkpoint_usable(std::get<I>(v)), 0)... };
+		return r;
+	}
+};
+
+struct checkpoint_record {
+	std::unique_ptr<checkpoint_slot> values;
+	std::size_t cache_pos; /* position in the multi-valued cache */
+	long long requests;
+};
+
+}
+
+/* owned by state_t::checkpoints, dropped at the end of exec() */
+struct checkpoint_list {
+	std::vector<internal::checkpoint_record> records;
+	unsigned next = 0;       /* index of the next checkpoint() call */
+	long long restored = 0;  /* statistics */
+
+	void record(std::unique_ptr<internal::checkpoint_slot> values, const state_t &st);
+	const internal::checkpoint_record * find_usable();
+	void resume(const internal::checkpoint_record &r, state_t &st);
+};
+
+/*! \addtogroup checkpoints
+ * @{ */
+
+/*! \brief Record the values of `vars` as the current progress of the
+ * computation.
+ *
+ * Has no effect inside limits and single_valued sections. */
+template <typename... Vars>
+void checkpoint(const Vars &... vars)
+{
+	state_t &st = *state;
+	if (st.ACTUAL_STACK.inlimit != 0 || st.reiterate_pending)
+		return;
+	if (!st.checkpoints)
+		st.checkpoints = new checkpoint_list;
+	st.checkpoints->record(std::unique_ptr<internal::checkpoint_slot>(
+		new internal::checkpoint_values<Vars...>(vars...)), st);
+}
+
+/*! \brief Resume from the newest checkpoint of an earlier iteration that is
+ * usable at the current precision.
+ *
+ * The types of `vars` have to match the ones passed to checkpoint().
+ * \return true if the variables have been assigned, false if the
+ *         computation has to start from the beginning. */
+template <typename... Vars>
+bool restore_checkpoint(Vars &... vars)
+{
+	state_t &st = *state;
+	if (st.ACTUAL_STACK.inlimit != 0 || !st.checkpoints)
+		return false;
+	const internal::checkpoint_record *r = st.checkpoints->find_usable();
+	if (!r)
+		return false;
+	auto *v = dynamic_cast<internal::checkpoint_values<Vars...> *>(r->values.get());
+	if (!v)
+		return false;
+	std::tie(vars...) = v->v;
+	st.checkpoints->resume(*r, st);
+	return true;
+}
+
+/*! @} */
+
+} // namespace iRRAM
+
+#endif /* ! iRRAM_CHECKPOINT_H */
@@ -12,6 +12,13 @@
 #define iRRAM_likely(x)		iRRAM_expect(!!(x), 1)
 #define iRRAM_unlikely(x)	iRRAM_expect(!!(x), 0)
 
+#if defined(__GNUC__) || defined(__clang__)
+/* marks the anonymous structs in REAL, which -pedantic would warn about */
+# define iRRAM_extension	__extension__
+#else
+# define iRRAM_extension
+#endif
+
 #include <iRRAM/version.h>
 
 #ifdef __cplusplus
@@ -20,7 +27,21 @@ extern "C" {
 
 #define iRRAM_DEFAULT_PREC_SKIP   5
 #define iRRAM_DEFAULT_PREC_START  1
+/* iterations with precision down to 2^iRRAM_DEFAULT_DD_PREC use double-double
+ * intervals instead of MPFR, 0 disables them; see iRRAM_set_dd_prec() */
+#ifndef iRRAM_DEFAULT_DD_PREC
+# define iRRAM_DEFAULT_DD_PREC    -100
+#endif
+/* number of exec()s that go from doubles straight to MPFR after an iteration
+ * on double-doubles failed */
+#define iRRAM_DD_BACKOFF          16
 #define iRRAM_DEFAULT_DEBUG       0
+/* reiterations are signalled by exceptions unless this is non-zero,
+ * see iRRAM::deferred_reiteration */
+#ifndef iRRAM_DEFAULT_DEFER_REITERATION
+# define iRRAM_DEFAULT_DEFER_REITERATION 0
+#endif
+#define iRRAM_DEFER_REITERATION_LIMIT 64
 
 struct iRRAM_init_options {
 	int    starting_prec;
@@ -50,6 +71,13 @@ void iRRAM_initialize3(const struct iRRAM_init_options *opts);
 
 int iRRAM_parse_args(struct iRRAM_init_options *opts, int *argc, char **argv);
 
+/*! \brief Iterations of this thread with precision down to 2^prec use
+ *         double-double intervals instead of MPFR, 0 disables them.
+ *
+ * Set by the option --dd_prec. It is not part of iRRAM_init_options, whose
+ * layout is fixed for binaries built against older versions. */
+void iRRAM_set_dd_prec(int prec);
+
 void iRRAM_finalize(void);
 
 extern const char *const *const iRRAM_error_msg;
@@ -31,8 +31,15 @@ MA 02111-1307, USA.
 #include <cstdint>	/* int32_t, uint32_t */
 #include <climits>
 #include <memory>	/* std::unique_ptr<state_t> */
+#include <string>
+#include <unordered_map>
+#include <atomic>
+#include <vector>
+#include <functional>
+#include <chrono>
 
 #include <iRRAM/common.h>
+#include <iRRAM/double_double.h>
 
 #ifndef iRRAM_BACKENDS
 # error error: no usable backend, defined iRRAM_BACKENDS
@@ -95,10 +102,11 @@ class REAL;
 class COMPLEX;
 class INTERVAL;
 class REALMATRIX;
+class REALVECTOR;
 class SPARSEREALMATRIX;
 template <typename R,typename... Args> class FUNCTION;
-struct cachelist;
-struct mv_cache;
+class mv_cache;
+struct checkpoint_list;
 
 
 struct iRRAM_Numerical_Exception {
@@ -114,6 +122,85 @@ struct ITERATION_DATA {
 	int prec_step;
 };
 
+/* precision steps exec_learned() succeeded with, see lib.h */
+struct precision_memory {
+	std::unordered_map<std::string,int> steps;
+	int hysteresis = 1;
+	long long calls   = 0; /* statistics */
+	long long skipped = 0; /* reiterations not needed due to a warm start */
+	long long missed  = 0; /* warm starts that had to reiterate */
+};
+
+/*! \brief Budgets of exec_bounded(); a value of 0 means unlimited. */
+struct exec_limits {
+	double seconds = 0;        /*!< wall-clock time */
+	std::size_t mp_memory = 0; /*!< estimated bytes in MPFR numbers */
+	int max_prec_step = 0;     /*!< highest precision step to use */
+};
+
+/*! \brief How exec_bounded() ended. */
+enum struct exec_status : int {
+	success,
+	time_limit,
+	memory_limit,
+	precision_limit,
+};
+
+/* thrown when one of the exec_limits is exceeded */
+struct exec_limit_exceeded {
+	exec_status status;
+};
+
+/*! \brief Accounting of the records of one type in the multi-valued cache. */
+struct cache_type_stats {
+	uint32_t tag = 0;
+	const char *name = nullptr;
+	std::size_t entries = 0;     /*!< records on the tape */
+	std::size_t bytes = 0;       /*!< their size, with headers and padding */
+	std::size_t max_entries = 0; /*!< high-water marks */
+	std::size_t max_bytes = 0;
+	unsigned long long hits = 0; /*!< records replayed */
+};
+
+/*! \brief Accounting of the multi-valued cache, see cache_statistics(). */
+struct cache_stats {
+	std::size_t bytes = 0;       /*!< size of the tape */
+	std::size_t max_bytes = 0;   /*!< its high-water mark */
+	std::size_t capacity = 0;    /*!< bytes allocated */
+	std::size_t limit = 0;       /*!< see cache_limit, 0: none */
+	std::vector<cache_type_stats> types; /*!< the types recorded so far */
+};
+
+extern const int iRRAM_prec_steps;
+extern const int *const iRRAM_prec_array;
+
+/*! \brief A schedule of working precisions, one for each of the
+ * \ref iRRAM_prec_steps precision steps.
+ *
+ * Step 0 is reserved, step 1 is the starting precision. The precisions are
+ * non-increasing with the step; the generators are clamped accordingly.
+ * The default ladder of all threads, \ref iRRAM_prec_array, is the geometric
+ * one given by the command line options --prec_init, --prec_inc and
+ * --prec_factor. Use the switch \ref use_ladder to work with another one. */
+class precision_ladder {
+	std::vector<int> p;
+public:
+	/*! \param gen returns the precision of step i >= 1 */
+	explicit precision_ladder(const std::function<int(int)> &gen);
+
+	/*! \brief the schedule of iRRAM_initialize3(): the increment of
+	 * `start` grows by `inc` and by `factor` every four steps */
+	static precision_ladder geometric(int start = -50, int inc = -20,
+	                                  double factor = 1.25);
+	/*! \brief the number of bits doubles every step */
+	static precision_ladder doubling(int start = -50);
+	/*! \brief adds `inc` bits every step */
+	static precision_ladder linear(int start = -50, int inc = -50);
+
+	const int * data() const noexcept { return p.data(); }
+	int operator[](int step) const noexcept { return p[step]; }
+};
+
 struct state_t {
 	int debug = iRRAM_DEFAULT_DEBUG;
 	int infinite = 0;
@@ -121,19 +208,42 @@ struct state_t {
 	int max_prec = 1;
 	int prec_start = iRRAM_DEFAULT_PREC_START;
 	bool highlevel = false; /* TODO: remove: iRRAM-timings revealed no performance loss */
+	bool ddlevel = false;   /* REALs are double-double intervals, see REAL::dd */
+	int dd_prec = iRRAM_DEFAULT_DD_PREC;
+	int dd_backoff = 0; /* exec()s left to skip double-doubles in */
 	/* The following boolean "inReiterate" is used to distinguish voluntary
 	 * deletions of rstreams from deletions initiated by iterations.
 	 * The latter should be ignored, as stream operations using this stream
 	 * might continue in later iterations! */
 	bool inReiterate = false;
 	int DYADIC_precision = -60;
-	cachelist *cache_active = nullptr;
-	int max_active = 0;
+	const int *prec_array = iRRAM_prec_array; /* see use_ladder */
 	mv_cache *cache_address = nullptr;
+	checkpoint_list *checkpoints = nullptr; /* see checkpoint.h */
+	precision_memory prec_memory;
+	/* set by exec_speculative() to abandon a running computation */
+	const std::atomic<bool> *cancel = nullptr;
+	/* see cache_limit in SWITCHES.h */
+	std::size_t cache_limit = 0;
+	bool cache_limit_error = false;
+	/* statistics of the cache of the last exec() */
+	cache_stats last_cache;
+	/* set by exec_bounded() */
+	const exec_limits *limits = nullptr;
+	std::chrono::steady_clock::time_point deadline;
+	int limits_peak_vars = 0;
+	/* deferred reiterations, see deferred_reiteration in SWITCHES.h */
+	bool defer_reiteration = iRRAM_DEFAULT_DEFER_REITERATION;
+	bool reiterate_pending = false;
+	int  pending_level = 0;     /* smallest inlimit a reiteration was deferred at */
+	int  pending_prec_diff = 0;
+	int  pending_count = 0;     /* deferrals since the last unwind */
+	long long deferred = 0;     /* statistics */
 
 	iRRAM_ext_mpfr_cache_t ext_mpfr_cache = iRRAM_EXT_MPFR_CACHE_INIT;
 	iRRAM_mpz_cache_t mpz_cache = iRRAM_MPZ_CACHE_INIT;
 	iRRAM_mpq_cache_t mpq_cache = iRRAM_MPQ_CACHE_INIT;
+	internal::dd_low_cache dd_low_cache;
 
 	REAL *ln2_val = nullptr;
 	int   ln2_err = 0;
@@ -153,6 +263,34 @@ struct state_t {
 	};
 };
 
+/* highlevel and ddlevel for the precision step in st.ACTUAL_STACK; limits
+ * and other single_valued sections work on MP numbers only */
+inline void set_precision_levels(state_t &st) noexcept
+{
+	const ITERATION_DATA &stack = st.ACTUAL_STACK;
+	st.highlevel = stack.prec_step > iRRAM_DEFAULT_PREC_START;
+	st.ddlevel = st.highlevel && st.dd_prec && stack.actual_prec >= st.dd_prec &&
+	             stack.inlimit == 0;
+}
+
+/* takes over the settings of `from` that decide how exec() iterates, e.g.
+ * into the states of the threads of exec_speculative() */
+inline void copy_exec_settings(state_t &st, const state_t &from) noexcept
+{
+	st.debug = from.debug;
+	st.infinite = from.infinite;
+	st.prec_skip = from.prec_skip;
+	st.prec_start = from.prec_start;
+	st.dd_prec = from.dd_prec;
+	st.DYADIC_precision = from.DYADIC_precision;
+	st.prec_array = from.prec_array;
+	st.cache_limit = from.cache_limit;
+	st.cache_limit_error = from.cache_limit_error;
+	st.limits = from.limits;
+	st.deadline = from.deadline;
+	st.defer_reiteration = from.defer_reiteration;
+}
+
 
 template <bool tls> struct state_proxy;
 
@@ -185,47 +323,21 @@ inline const ITERATION_DATA & actual_stack(const state_t &st = *state)
 	return st.ACTUAL_STACK;
 }
 
-template <typename T> class cache;
-
-template <typename T> cache<T> & get_cache(const state_t &st = *state);
+/* multi-valued operations, defined in cache.h */
+template <typename T> struct tape_codec;
 template <typename T> bool get_cached(T &t, const state_t &st = *state);
 template <typename T> void put_cached(const T &t, const state_t &st = *state);
 template <typename T> void modify_cached(const T &t, const state_t &st = *state);
 
-template <typename T>
-inline cache<T> & get_cache(const state_t &st)
-{
-	return *static_cast<cache<T> *>(st.cache_address);
-}
-
-template <typename T>
-inline bool get_cached(T &t, const state_t &st)
-{
-	return st.ACTUAL_STACK.inlimit == 0 && get_cache<T>(st).get(t);
-}
-
-template <typename T>
-inline void put_cached(const T &t, const state_t &st)
-{
-	if (st.ACTUAL_STACK.inlimit == 0)
-		get_cache<T>(st).put(t);
-}
-
-template <typename T>
-inline void modify_cached(const T &t, const state_t &st)
-{
-	if (st.ACTUAL_STACK.inlimit == 0)
-		get_cache<T>(st).modify(t);
-}
+/*! \brief Accounting of the multi-valued cache of the running exec() or, if
+ * there is none, of the last one. */
+const cache_stats & cache_statistics(state_t &st = *state);
 
 extern void resources(double&,unsigned int&);
 extern double ln2_time;
 extern double pi_time;
 void show_statistics();
 
-extern const int iRRAM_prec_steps;
-extern const int *const iRRAM_prec_array;
-
 inline bool debug_enabled(int level)
 {
 	const state_t &st = *state;
@@ -250,6 +362,74 @@ struct Iteration {
 	constexpr Iteration(int p) : prec_diff(p) {}
 };
 
+/* thrown at a cancellation point when the computation is not needed
+ * anymore, see exec_speculative() */
+struct exec_cancelled {};
+
+void check_exec_limits(state_t &st);
+
+/* multi-valued operations are safe points to stop a computation at */
+inline void cancellation_point(state_t &st = *state)
+{
+	if (iRRAM_unlikely(st.cancel != nullptr) &&
+	    st.cancel->load(std::memory_order_relaxed))
+		throw exec_cancelled();
+	if (iRRAM_unlikely(st.limits != nullptr))
+		check_exec_limits(st);
+}
+
+/*! \brief Record a reiteration instead of throwing Iteration, if enabled.
+ *
+ * Used by the multi-valued operations when their argument is not precise
+ * enough. In deferred mode they then return an arbitrary result and the
+ * computation continues with poisoned values until the next
+ * reiteration_point() of the current limit or the end of exec(), where a
+ * single unwind takes place. After iRRAM_DEFER_REITERATION_LIMIT
+ * deferrals it throws the pending Iteration itself.
+ * \return false if the caller has to iRRAM_REITERATE(p_diff) itself */
+inline bool defer_reiteration(int p_diff, state_t &st = *state)
+{
+	if (iRRAM_likely(!st.defer_reiteration))
+		return false;
+	int level = st.ACTUAL_STACK.inlimit;
+	if (!st.reiterate_pending) {
+		st.reiterate_pending = true;
+		st.pending_level = level;
+		st.pending_prec_diff = p_diff;
+		st.pending_count = 0;
+	} else {
+		st.pending_level = min(st.pending_level, level);
+		st.pending_prec_diff = min(st.pending_prec_diff, p_diff);
+	}
+	st.inReiterate = true;
+	st.deferred++;
+	/* poisoned values might keep a loop of the user running forever */
+	if (++st.pending_count <= iRRAM_DEFER_REITERATION_LIMIT)
+		return true;
+	/* unwind now like reiteration_point(), unless the reiteration was
+	 * deferred outside of the current limit: that one stays pending */
+	if (st.pending_level >= level) {
+		st.reiterate_pending = false;
+		st.pending_count = 0;
+		throw Iteration(st.pending_prec_diff);
+	}
+	return false;
+}
+
+/*! \brief Throw the Iteration deferred at the current limit level or
+ * inside of it.
+ *
+ * Reiterations deferred outside of the current limit are left for the
+ * enclosing one or exec(); the limit's result will be discarded anyway. */
+inline void reiteration_point(state_t &st = *state)
+{
+	if (iRRAM_unlikely(st.reiterate_pending) &&
+	    st.pending_level >= st.ACTUAL_STACK.inlimit) {
+		st.reiterate_pending = false;
+		throw Iteration(st.pending_prec_diff);
+	}
+}
+
 // inline void iRRAM_REITERATE(int p_diff){inReiterate = true; throw Iteration(p_diff); }
 #define iRRAM_REITERATE(x)                                                           \
 	do {                                                                   \
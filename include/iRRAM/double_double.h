@@ -0,0 +1,253 @@
+/*
+ * double_double.h -- double-double intervals between the first iteration
+ *                    and MPFR
+ *
+ * This file is part of the iRRAM Library.
+ *
+ * The iRRAM Library is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Library General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * The iRRAM Library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Library General Public
+ * License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public License
+ * along with the iRRAM Library; see the file COPYING.LIB.  If not, write to
+ * the Free Software Foundation, Inc., 59 Temple Place - Suite 330, Boston,
+ * MA 02111-1307, USA.
+ */
+
+#ifndef iRRAM_DOUBLE_DOUBLE_H
+#define iRRAM_DOUBLE_DOUBLE_H
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+namespace iRRAM {
+namespace internal {
+
+/*! \brief The unevaluated sum `hi + lo` of two doubles, about 106 bits. */
+struct double_double {
+	double hi, lo;
+};
+
+/*! \brief The interval \f$[x_L,x_U]\f$ of a REAL in the iterations using
+ * double-double bounds, stored as \f$(x_L,-x_U)\f$ like double_pair. */
+struct dd_pair {
+	double_double lower_pos, upper_neg;
+};
+
+/* the low parts of a dd_pair, kept out of line by REAL */
+struct dd_low {
+	double lower_pos, upper_neg;
+};
+
+#define iRRAM_DD_LOW_CACHE_SIZE 1000
+
+/* free list of dd_lows in state_t, as ext_mpfr_cache is for MPFR numbers */
+struct dd_low_cache {
+	int free_count = 0;
+	dd_low *free_lows[iRRAM_DD_LOW_CACHE_SIZE];
+
+	dd_low_cache() = default;
+	dd_low_cache(const dd_low_cache &) = delete;
+	dd_low_cache & operator=(const dd_low_cache &) = delete;
+	~dd_low_cache()
+	{
+		while (free_count)
+			delete free_lows[--free_count];
+	}
+
+	dd_low * alloc()
+	{
+		if (free_count > 0)
+			return free_lows[--free_count];
+		return new dd_low;
+	}
+
+	void free(dd_low *l) noexcept
+	{
+		if (free_count < iRRAM_DD_LOW_CACHE_SIZE)
+			free_lows[free_count++] = l;
+		else
+			delete l;
+	}
+};
+
+/* As for double_pair, the kernels expect the rounding mode FE_DOWNWARD set
+ * by exec(). Every double_double they return is a lower bound of the exact
+ * result, so the upper bounds are computed as the lower bounds of the
+ * negated results. The error-free transformations are written such that
+ * each rounding can only decrease the sum, hence they stay rigorous in the
+ * cases where rounding downward makes them inexact. */
+namespace dd_ops {
+
+inline double_double neg(const double_double &a) noexcept
+{
+	return { -a.hi, -a.lo };
+}
+
+/* exact: rounding downward, hi + lo < 0 cannot give 0 or more */
+inline bool nonneg  (const double_double &a) noexcept { return a.hi + a.lo >= 0; }
+inline bool positive(const double_double &a) noexcept { return a.hi + a.lo >  0; }
+
+/* hi + lo <= s + t, hi = s + t rounded */
+inline double_double renorm(double s, double t) noexcept
+{
+	double h = s + t;
+	double z = -(s - h); /* >= h - s */
+	return { h, t - z };
+}
+
+/* hi + lo <= a + b, hi = a + b rounded, after Knuth's TwoSum */
+inline double_double two_sum(double a, double b) noexcept
+{
+	double s = a + b;
+	double bb = s - a;
+	double aa = -(bb - s); /* >= s - bb */
+	return { s, (a - aa) + (b - bb) };
+}
+
+/* hi + lo <= a * b, hi = a * b rounded */
+inline double_double two_prod(double a, double b) noexcept
+{
+	double p = a * b;
+#ifdef FP_FAST_FMA
+	return { p, std::fma(a, b, -p) };
+#else
+	/* Dekker's product on halves of at most 26 and 27 bits obtained by
+	 * truncation, so that all but the last partial product are exact */
+	auto split = [](double x) {
+		std::uint64_t u;
+		std::memcpy(&u, &x, sizeof(u));
+		u &= ~std::uint64_t(0) << 27;
+		std::memcpy(&x, &u, sizeof(u));
+		return x;
+	};
+	double a1 = split(a), a2 = a - a1;
+	double b1 = split(b), b2 = b - b1;
+	return { p, ((a1 * b1 - p) + a1 * b2 + a2 * b1) + a2 * b2 };
+#endif
+}
+
+inline double_double add(const double_double &a, const double_double &b) noexcept
+{
+	double_double s = two_sum(a.hi, b.hi);
+	return renorm(s.hi, (a.lo + b.lo) + s.lo);
+}
+
+inline double_double mul(const double_double &a, const double_double &b) noexcept
+{
+	double_double p = two_prod(a.hi, b.hi);
+	double t = a.hi * b.lo + a.lo * b.hi;
+	return renorm(p.hi, (t + a.lo * b.lo) + p.lo);
+}
+
+/* b > 0 */
+inline double_double div(const double_double &a, const double_double &b) noexcept
+{
+	double q = a.hi / b.hi;
+	double_double r = add(a, mul({ -q, 0.0 }, b)); /* <= a - q*b */
+	double rd = r.hi + r.lo;
+	/* rd/b >= rd/(upper bound of b) if rd >= 0, else rd/(lower bound) */
+	double bd = rd >= 0 ? -(-b.hi - b.lo) : b.hi + b.lo;
+	return renorm(q, rd / bd);
+}
+
+/* a lower bound of min(a, b) */
+inline double_double min(const double_double &a, const double_double &b) noexcept
+{
+	double_double d = add(b, neg(a)); /* <= b - a */
+	return nonneg(d) ? a : add(a, d);
+}
+
+inline dd_pair neg(const dd_pair &x) noexcept
+{
+	return { x.upper_neg, x.lower_pos };
+}
+
+inline dd_pair add(const dd_pair &x, const dd_pair &y) noexcept
+{
+	return { add(x.lower_pos, y.lower_pos), add(x.upper_neg, y.upper_neg) };
+}
+
+inline dd_pair sub(const dd_pair &x, const dd_pair &y) noexcept
+{
+	return add(x, neg(y));
+}
+
+inline dd_pair mul(const dd_pair &x, const dd_pair &y) noexcept
+{
+	const double_double &xl = x.lower_pos, &xn = x.upper_neg;
+	const double_double &yl = y.lower_pos, &yn = y.upper_neg;
+	const double_double xu = neg(xn), yu = neg(yn);
+	if (nonneg(xl)) {
+		if (nonneg(yl))
+			return { mul(xl, yl), mul(xn, yu) };
+		if (nonneg(yn))
+			return { mul(xu, yl), mul(neg(xl), yu) };
+		return { mul(xu, yl), mul(xn, yu) };
+	}
+	if (nonneg(xn)) {
+		if (nonneg(yl))
+			return { mul(xl, yu), mul(xn, yl) };
+		if (nonneg(yn))
+			return { mul(xu, yu), mul(neg(xl), yl) };
+		return { mul(xl, yu), mul(neg(xl), yl) };
+	}
+	if (nonneg(yl))
+		return { mul(xl, yu), mul(xn, yu) };
+	if (nonneg(yn))
+		return { mul(xu, yl), mul(neg(xl), yl) };
+	return { min(mul(xl, yu), mul(xu, yl)),
+	         min(mul(neg(xl), yl), mul(xn, yu)) };
+}
+
+/* false if y contains zero or is too close to it */
+inline bool div(dd_pair &z, const dd_pair &x, const dd_pair &y) noexcept
+{
+	dd_pair a = x, b = y;
+	if (!positive(b.lower_pos)) {
+		/* x/y = (-x)/(-y) */
+		if (!positive(y.upper_neg))
+			return false;
+		a = neg(x);
+		b = neg(y);
+	}
+	const double_double bu = neg(b.upper_neg);
+	if (!(b.lower_pos.hi > 0 && bu.hi > 0))
+		return false;
+	z.lower_pos = div(a.lower_pos, nonneg(a.lower_pos) ? bu : b.lower_pos);
+	z.upper_neg = div(a.upper_neg, nonneg(a.upper_neg) ? bu : b.lower_pos);
+	return true;
+}
+
+inline dd_pair square(const dd_pair &x) noexcept
+{
+	const double_double &l = x.lower_pos, &n = x.upper_neg;
+	if (nonneg(l))
+		return { mul(l, l), mul(n, neg(n)) };
+	if (nonneg(n))
+		return { mul(n, n), mul(neg(l), l) };
+	return { { 0.0, 0.0 }, min(mul(neg(l), l), mul(n, neg(n))) };
+}
+
+inline dd_pair abs(const dd_pair &x) noexcept
+{
+	if (nonneg(x.lower_pos))
+		return x;
+	if (nonneg(x.upper_neg))
+		return neg(x);
+	return { { 0.0, 0.0 }, min(x.lower_pos, x.upper_neg) };
+}
+
+} // namespace dd_ops
+
+} // namespace internal
+} // namespace iRRAM
+
+#endif /* iRRAM_DOUBLE_DOUBLE_H */
@@ -0,0 +1,384 @@
+/*
+ * double_pair.h -- double intervals for the first iteration of REAL
+ *
+ * This file is part of the iRRAM Library.
+ *
+ * The iRRAM Library is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Library General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * The iRRAM Library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Library General Public
+ * License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public License
+ * along with the iRRAM Library; see the file COPYING.LIB.  If not, write to
+ * the Free Software Foundation, Inc., 59 Temple Place - Suite 330, Boston,
+ * MA 02111-1307, USA.
+ */
+
+#ifndef iRRAM_DOUBLE_PAIR_H
+#define iRRAM_DOUBLE_PAIR_H
+
+#include <cfloat>
+#include <cmath>
+#include <limits>
+
+#include <iRRAM/version.h>
+
+/* Define iRRAM_NO_SIMD to use the portable kernels even if the compiler
+ * targets SSE2. The layout of double_pair is the same either way, so
+ * translation units built with and without SIMD can be mixed. */
+#if defined(__SSE2__) && !defined(iRRAM_NO_SIMD)
+# include <emmintrin.h>
+# define iRRAM_HAVE_SSE2 1
+# ifdef __AVX__
+#  include <immintrin.h>
+#  define iRRAM_HAVE_AVX 1
+# endif
+#endif
+
+namespace iRRAM {
+namespace internal {
+
+/*! \brief The interval \f$[x_L,x_U]\f$ of a REAL in the first iteration,
+ * stored as \f$(x_L,-x_U)\f$.
+ *
+ * All kernels below expect the rounding mode FE_DOWNWARD set by exec(). The
+ * upper bound is then obtained as the negated lower bound of the negated
+ * result, so both components are computed with the same rounding.
+ *
+ * It is only aligned to 8 bytes, which keeps a REAL at 40 bytes; the SIMD
+ * kernels load and store it unaligned. */
+struct double_pair {
+	double lower_pos, upper_neg;
+
+	double_pair() noexcept {}
+	double_pair(double l, double u) noexcept : lower_pos(l), upper_neg(u) {}
+#ifdef iRRAM_HAVE_SSE2
+	double_pair(__m128d v) noexcept { _mm_storeu_pd(&lower_pos, v); }
+	__m128d sse() const noexcept { return _mm_loadu_pd(&lower_pos); }
+#endif
+};
+
+/* The kernels distinguish the cases by the signs of the bounds. They are
+ * the reference for the SIMD versions and used where those are missing. */
+namespace dp_generic {
+
+inline double_pair add(const double_pair &x, const double_pair &y) noexcept
+{
+	return double_pair(x.lower_pos + y.lower_pos, x.upper_neg + y.upper_neg);
+}
+
+inline double_pair sub(const double_pair &x, const double_pair &y) noexcept
+{
+	return double_pair(x.lower_pos + y.upper_neg, x.upper_neg + y.lower_pos);
+}
+
+inline double_pair neg(const double_pair &x) noexcept
+{
+	return double_pair(x.upper_neg, x.lower_pos);
+}
+
+inline double_pair mul(const double_pair &x, const double_pair &y) noexcept
+{
+	double_pair z;
+	if (x.lower_pos >= 0 && y.lower_pos >= 0) {
+		z.lower_pos =   x.lower_pos  * y.lower_pos;
+		z.upper_neg = (-x.upper_neg) * y.upper_neg;
+	} else if (x.upper_neg >= 0 && y.upper_neg >= 0) {
+		z.lower_pos =   x.upper_neg  * y.upper_neg;
+		z.upper_neg = (-x.lower_pos) * y.lower_pos;
+	} else if (x.upper_neg >= 0 && y.lower_pos >= 0) {
+		z.lower_pos = x.lower_pos * (-y.upper_neg);
+		z.upper_neg = x.upper_neg *   y.lower_pos;
+	} else if (x.lower_pos >= 0 && y.upper_neg >= 0) {
+		z.lower_pos = (-x.upper_neg) * y.lower_pos;
+		z.upper_neg =   x.lower_pos  * y.upper_neg;
+	} else {
+		z.lower_pos = fmin((-x.upper_neg) *   y.lower_pos,
+		                     x.lower_pos  * (-y.upper_neg));
+		z.upper_neg = fmin((-x.upper_neg) *   y.upper_neg,
+		                     x.lower_pos  * (-y.lower_pos));
+	}
+	return z;
+}
+
+inline double_pair mul(const double_pair &x, int n) noexcept
+{
+	if (n >= 0)
+		return double_pair(x.lower_pos * n, x.upper_neg * n);
+	return double_pair((-x.upper_neg) * n, (-x.lower_pos) * n);
+}
+
+/* x*y+z, the same cases as mul() with z added before the only rounding */
+inline double_pair fma(const double_pair &x, const double_pair &y,
+                       const double_pair &z) noexcept
+{
+#ifdef FP_FAST_FMA
+	double_pair r;
+	if (x.lower_pos >= 0 && y.lower_pos >= 0) {
+		r.lower_pos = std::fma( x.lower_pos,  y.lower_pos, z.lower_pos);
+		r.upper_neg = std::fma(-x.upper_neg,  y.upper_neg, z.upper_neg);
+	} else if (x.upper_neg >= 0 && y.upper_neg >= 0) {
+		r.lower_pos = std::fma( x.upper_neg,  y.upper_neg, z.lower_pos);
+		r.upper_neg = std::fma(-x.lower_pos,  y.lower_pos, z.upper_neg);
+	} else if (x.upper_neg >= 0 && y.lower_pos >= 0) {
+		r.lower_pos = std::fma( x.lower_pos, -y.upper_neg, z.lower_pos);
+		r.upper_neg = std::fma( x.upper_neg,  y.lower_pos, z.upper_neg);
+	} else if (x.lower_pos >= 0 && y.upper_neg >= 0) {
+		r.lower_pos = std::fma(-x.upper_neg,  y.lower_pos, z.lower_pos);
+		r.upper_neg = std::fma( x.lower_pos,  y.upper_neg, z.upper_neg);
+	} else {
+		r.lower_pos = fmin(std::fma(-x.upper_neg,  y.lower_pos, z.lower_pos),
+		                   std::fma( x.lower_pos, -y.upper_neg, z.lower_pos));
+		r.upper_neg = fmin(std::fma(-x.upper_neg,  y.upper_neg, z.upper_neg),
+		                   std::fma( x.lower_pos, -y.lower_pos, z.upper_neg));
+	}
+	return r;
+#else
+	/* std::fma() would be emulated in software */
+	return add(mul(x, y), z);
+#endif
+}
+
+/* false if y contains zero */
+inline bool div(double_pair &z, const double_pair &x, const double_pair &y) noexcept
+{
+	if (y.lower_pos > 0.0) {
+		if (x.lower_pos > 0.0) {
+			z.lower_pos = x.lower_pos/(-y.upper_neg);
+			z.upper_neg = x.upper_neg/  y.lower_pos;
+		} else if (x.upper_neg  > 0.0){
+			z.lower_pos = x.lower_pos/  y.lower_pos;
+			z.upper_neg = x.upper_neg/(-y.upper_neg);
+		} else {
+			z.lower_pos = x.lower_pos/  y.lower_pos;
+			z.upper_neg = x.upper_neg/  y.lower_pos;
+		}
+	} else if (y.upper_neg > 0.0) {
+		if (x.lower_pos > 0.0 ) {
+			z.lower_pos =   x.upper_neg /y.upper_neg;
+			z.upper_neg = (-x.lower_pos)/y.lower_pos;
+		} else if (x.upper_neg  > 0.0){
+			z.lower_pos = (-x.upper_neg)/y.lower_pos;
+			z.upper_neg =   x.lower_pos /y.upper_neg;
+		} else {
+			z.lower_pos = x.upper_neg   /y.upper_neg;
+			z.upper_neg = x.lower_pos   /y.upper_neg;
+		}
+	} else
+		return false;
+	return true;
+}
+
+/* n != 0 */
+inline double_pair div(const double_pair &x, int n) noexcept
+{
+	if (n > 0)
+		return double_pair(x.lower_pos / n, x.upper_neg / n);
+	return double_pair((-x.upper_neg) / n, (-x.lower_pos) / n);
+}
+
+inline double_pair square(const double_pair &x) noexcept
+{
+	if (x.lower_pos >= 0)
+		return double_pair(  x.lower_pos  * x.lower_pos,
+		                   (-x.upper_neg) * x.upper_neg);
+	if (x.upper_neg >= 0)
+		return double_pair(  x.upper_neg  * x.upper_neg,
+		                   (-x.lower_pos) * x.lower_pos);
+	if (x.lower_pos < x.upper_neg)
+		return double_pair(0.0, x.lower_pos * (-x.lower_pos));
+	return double_pair(0.0, (-x.upper_neg) * x.upper_neg);
+}
+
+inline double_pair abs(const double_pair &x) noexcept
+{
+	if (x.lower_pos > 0.0)
+		return x;
+	if (x.upper_neg > 0.0)
+		return neg(x);
+	if (x.lower_pos > x.upper_neg)
+		return double_pair(0.0, x.upper_neg);
+	return double_pair(0.0, x.lower_pos);
+}
+
+} // namespace dp_generic
+
+#ifdef iRRAM_HAVE_SSE2
+/* Branch-free versions: each bound is the minimum of all candidates, which
+ * are computed in both lanes at once. Exchanging the lanes negates an
+ * interval, so only products and quotients need explicit sign changes. */
+namespace dp_simd {
+
+inline __m128d swap(__m128d v) noexcept { return _mm_shuffle_pd(v, v, 1); }
+inline __m128d flip(__m128d v) noexcept { return _mm_xor_pd(v, _mm_set1_pd(-0.0)); }
+
+/* (min(a0,a1), min(b0,b1)) */
+inline __m128d hmin(__m128d a, __m128d b) noexcept
+{
+	return _mm_min_pd(_mm_unpacklo_pd(a, b), _mm_unpackhi_pd(a, b));
+}
+
+inline double_pair add(const double_pair &x, const double_pair &y) noexcept
+{
+	return _mm_add_pd(x.sse(), y.sse());
+}
+
+inline double_pair sub(const double_pair &x, const double_pair &y) noexcept
+{
+	return _mm_add_pd(x.sse(), swap(y.sse()));
+}
+
+inline double_pair neg(const double_pair &x) noexcept
+{
+	return swap(x.sse());
+}
+
+inline double_pair mul(const double_pair &x, const double_pair &y) noexcept
+{
+	__m128d a = x.sse(), b = y.sse(), bs = swap(b);
+#ifdef iRRAM_HAVE_AVX
+	/* lower half: x_L*y_L, x_{-U}*y_{-U}, x_L*y_U, x_U*y_L
+	 * upper half: the negated products for the upper bound */
+	__m256d p = _mm256_mul_pd(
+		_mm256_insertf128_pd(_mm256_castpd128_pd256(a), flip(a), 1),
+		_mm256_insertf128_pd(_mm256_castpd128_pd256(b), b, 1));
+	__m256d q = _mm256_mul_pd(
+		_mm256_insertf128_pd(_mm256_castpd128_pd256(a), a, 1),
+		_mm256_insertf128_pd(_mm256_castpd128_pd256(flip(bs)), bs, 1));
+	__m256d m = _mm256_min_pd(p, q);
+	return hmin(_mm256_castpd256_pd128(m), _mm256_extractf128_pd(m, 1));
+#else
+	__m128d lo = _mm_min_pd(_mm_mul_pd(a, b), _mm_mul_pd(a, flip(bs)));
+	__m128d up = _mm_min_pd(_mm_mul_pd(flip(a), b), _mm_mul_pd(a, bs));
+	return hmin(lo, up);
+#endif
+}
+
+inline double_pair mul(const double_pair &x, int n) noexcept
+{
+	if (n >= 0)
+		return _mm_mul_pd(x.sse(), _mm_set1_pd(n));
+	return _mm_mul_pd(swap(x.sse()), _mm_set1_pd(-double(n)));
+}
+
+inline double_pair fma(const double_pair &x, const double_pair &y,
+                       const double_pair &z) noexcept
+{
+#if defined(iRRAM_HAVE_AVX) && defined(__FMA__)
+	/* the candidates of mul() with z_L resp. z_{-U} added */
+	__m128d a = x.sse(), b = y.sse(), bs = swap(b);
+	__m256d c = _mm256_insertf128_pd(
+		_mm256_castpd128_pd256(_mm_set1_pd(z.lower_pos)),
+		_mm_set1_pd(z.upper_neg), 1);
+	__m256d p = _mm256_fmadd_pd(
+		_mm256_insertf128_pd(_mm256_castpd128_pd256(a), flip(a), 1),
+		_mm256_insertf128_pd(_mm256_castpd128_pd256(b), b, 1), c);
+	__m256d q = _mm256_fmadd_pd(
+		_mm256_insertf128_pd(_mm256_castpd128_pd256(a), a, 1),
+		_mm256_insertf128_pd(_mm256_castpd128_pd256(flip(bs)), bs, 1), c);
+	__m256d m = _mm256_min_pd(p, q);
+	return hmin(_mm256_castpd256_pd128(m), _mm256_extractf128_pd(m, 1));
+#else
+	return add(mul(x, y), z);
+#endif
+}
+
+/* false if y contains zero */
+inline bool div(double_pair &z, const double_pair &x, const double_pair &y) noexcept
+{
+	__m128d a = x.sse();
+	double l, u;
+	if (y.lower_pos > 0.0) {
+		l = y.lower_pos;
+		u = -y.upper_neg;
+	} else if (y.upper_neg > 0.0) {
+		/* x/y = (-x)/(-y) */
+		a = swap(a);
+		l = y.upper_neg;
+		u = -y.lower_pos;
+	} else
+		return false;
+#ifdef iRRAM_HAVE_AVX
+	__m256d q = _mm256_div_pd(
+		_mm256_insertf128_pd(_mm256_castpd128_pd256(a), a, 1),
+		_mm256_insertf128_pd(_mm256_castpd128_pd256(_mm_set1_pd(l)),
+		                     _mm_set1_pd(u), 1));
+	z = _mm_min_pd(_mm256_castpd256_pd128(q), _mm256_extractf128_pd(q, 1));
+#else
+	z = _mm_min_pd(_mm_div_pd(a, _mm_set1_pd(l)),
+	               _mm_div_pd(a, _mm_set1_pd(u)));
+#endif
+	return true;
+}
+
+/* n != 0 */
+inline double_pair div(const double_pair &x, int n) noexcept
+{
+	if (n > 0)
+		return _mm_div_pd(x.sse(), _mm_set1_pd(n));
+	return _mm_div_pd(swap(x.sse()), _mm_set1_pd(-double(n)));
+}
+
+inline double_pair square(const double_pair &x) noexcept
+{
+	__m128d a = x.sse();
+	/* lower bound max(x_L,-x_U,0), upper bound max(|x_L|,|x_U|) */
+	__m128d m = _mm_max_pd(_mm_max_pd(a, swap(a)), _mm_setzero_pd());
+	__m128d b = _mm_andnot_pd(_mm_set1_pd(-0.0), a);
+	__m128d v = _mm_move_sd(_mm_max_pd(b, swap(b)), m);
+	return _mm_mul_pd(_mm_xor_pd(v, _mm_set_pd(-0.0, 0.0)), v);
+}
+
+inline double_pair abs(const double_pair &x) noexcept
+{
+	__m128d a = x.sse(), s = swap(a);
+	__m128d m = _mm_max_pd(_mm_max_pd(a, s), _mm_setzero_pd());
+	return _mm_move_sd(_mm_min_pd(a, s), m);
+}
+
+} // namespace dp_simd
+
+namespace dp_ops = dp_simd;
+#else
+namespace dp_ops = dp_generic;
+#endif
+
+/* iRRAM_LIBM_ULPS from version.h bounds the units in the last place by which
+ * exp, log, sin and cos of the C library may miss the exact values in the
+ * rounding mode FE_DOWNWARD. C does not specify any bound, so configure only
+ * assumes one for glibc >= 2.28: it tests these functions in all rounding
+ * modes and its manual lists errors of at most 1 or 2 ulps for common
+ * targets, 4 leaves a margin. For other C libraries the bound is 0 unless
+ * given by --with-libm-ulps, and dp_exp(), dp_log(), dp_sin() and dp_cos()
+ * always return false. */
+
+/* [lower,upper] widened to contain the exact values of which lower and upper
+ * are libm results. The bound is doubled as the ulp of the exact value may
+ * be twice that of the result at a power of 2. */
+inline double_pair widen_libm(double lower, double upper) noexcept
+{
+	const double rel = 2 * iRRAM_LIBM_ULPS * DBL_EPSILON;
+	const double abs = 2 * iRRAM_LIBM_ULPS *
+	                   std::numeric_limits<double>::denorm_min();
+	return double_pair(lower - std::fabs(lower) * rel - abs,
+	                   -upper - std::fabs(upper) * rel - abs);
+}
+
+/* Enclosures z of f(x) for the first iteration. They return false where
+ * only the MP versions apply, e.g. outside of the domain of f, for huge
+ * arguments or without a known iRRAM_LIBM_ULPS. */
+bool dp_sqrt(double_pair &z, const double_pair &x) noexcept;
+bool dp_exp (double_pair &z, const double_pair &x) noexcept;
+bool dp_log (double_pair &z, const double_pair &x) noexcept;
+bool dp_sin (double_pair &z, const double_pair &x) noexcept;
+bool dp_cos (double_pair &z, const double_pair &x) noexcept;
+
+} // namespace internal
+} // namespace iRRAM
+
+#endif /* iRRAM_DOUBLE_PAIR_H */
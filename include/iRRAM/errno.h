@@ -9,3 +9,4 @@ ERRORDEFINE(iRRAM_cacheerror_skonvert,     "iRRAM_cacheerror_skonvert")
 ERRORDEFINE(iRRAM_cacheerror_ikonvert,     "iRRAM_cacheerror_ikonvert")
 ERRORDEFINE(iRRAM_conversion_from_infinite,"iRRAM_conversion_from_infinite")
 ERRORDEFINE(iRRAM_general_divide_by_zero,  "iRRAM_general_divide_by_zero")
+ERRORDEFINE(iRRAM_cache_overflow,          "iRRAM_cache_overflow")
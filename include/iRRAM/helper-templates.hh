@@ -17,6 +17,27 @@ using enable_if_compat = typename std::enable_if<
 	std::is_convertible<Compat,Base>::value
 ,Ret>::type;
 
+/* helpers for binary operator overloads on rvalues of Base, with the operands
+ * taken as forwarding references X&&, Y&&: X&& is an rvalue of Base iff X is
+ * Base, the other operand is any Base, an lvalue of Base or an int */
+template <typename Base,typename X,typename Y,typename Ret = Base>
+using enable_if_rvalue_op = typename std::enable_if<
+	std::is_same<X,Base>::value &&
+	std::is_same<typename std::decay<Y>::type,Base>::value
+,Ret>::type;
+
+template <typename Base,typename X,typename Y,typename Ret = Base>
+using enable_if_lvalue_rvalue_op = typename std::enable_if<
+	std::is_lvalue_reference<X>::value &&
+	std::is_same<typename std::decay<X>::type,Base>::value &&
+	std::is_same<Y,Base>::value
+,Ret>::type;
+
+template <typename Base,typename X,typename I,typename Ret = Base>
+using enable_if_rvalue_int_op = typename std::enable_if<
+	std::is_same<X,Base>::value && std::is_same<I,int>::value
+,Ret>::type;
+
 template <typename Base,typename Ret = bool>
 struct conditional_comparison_overloads {
 	template <typename A,typename B> friend enable_if_compat<Base,A,B,Ret> operator<(const A &a, const B &b) { return a<Base(b); }
@@ -53,6 +53,11 @@ Authors:  all by Norbert, except:
  * \defgroup debug Debug
  */
 
+/*!
+ * \defgroup exec Running computations
+ * \brief exec() and the other drivers of the reiteration loop.
+ */
+
 #ifndef iRRAM_LIB_H
 #define iRRAM_LIB_H
 
@@ -62,6 +67,7 @@ Authors:  all by Norbert, except:
 #include <iRRAM/INTEGER.h>
 #include <iRRAM/RATIONAL.h>
 #include <iRRAM/REALMATRIX.h>
+#include <iRRAM/REALVECTOR.h>
 #include <iRRAM/SPARSEREALMATRIX.h>
 #include <iRRAM/COMPLEX.h>
 #include <iRRAM/INTERVAL.h>
@@ -70,6 +76,12 @@ Authors:  all by Norbert, except:
 #include <iRRAM/FUNCTION.h>
 #include <iRRAM/helper-templates.hh>
 #include <iRRAM/limit_templates.h>
+#include <iRRAM/checkpoint.h>
+
+#include <typeinfo>
+#include <vector>
+#include <cstdio>
+#include <chrono>
 
 namespace iRRAM {
 
@@ -77,17 +89,51 @@ namespace iRRAM {
 // iRRAM_exec template
 
 namespace internal {
+
+/* the multi-valued cache of one input of exec_batch() that has to be
+ * reiterated, swapped with the contents of the cache of the run */
+struct batch_context {
+	mv_cache *cache_address = nullptr;
+	checkpoint_list *checkpoints = nullptr;
+	long long outputs = 0;
+	int prec_step;
+
+	batch_context() = default;
+	batch_context(const batch_context &) = delete;
+	batch_context & operator=(const batch_context &) = delete;
+	~batch_context();
+};
+
 class run {
 
 	state_t &st;
 	stiff code;
 
+	int step_inc;
+	const char *dump_path = nullptr;
+	bool own_context = true;
+
+	void start();
 	void loop_init();
 	void loop_fini(int p_end);
+	void batch_enter(batch_context &c);
+	void batch_leave(batch_context &c, bool done, int p_end);
+
+	friend void precision_memory_learn(const run &r, const std::string &key,
+	                                   int start_step);
 public:
 	run(state_t &st);
+	run(state_t &st, int start_step, int step_inc = 4);
+	run(state_t &st, mv_cache *cache_address);
 	~run();
 
+	/* resume from the dump in `path`, if any, and write a dump there after
+	 * each failed iteration */
+	void persist(const char *path);
+
+	/* the fewest iterations from --prec_start to precision step `step` */
+	int iterations_to(int step) const;
+
 	template <typename F,typename... Args>
 	ret_void_t<F,Args...> exec(F f, const Args &... args)
 	{
@@ -98,7 +144,9 @@ public:
 			int p_end = 0;
 			try {
 				f(args...);
-				if (iRRAM_likely(!st.infinite))
+				if (iRRAM_unlikely(st.reiterate_pending))
+					p_end = actual_stack.actual_prec + st.pending_prec_diff;
+				else if (iRRAM_likely(!st.infinite))
 					break;
 			} catch (const Iteration &it) {
 				p_end = actual_stack.actual_prec + it.prec_diff;
@@ -120,9 +168,57 @@ public:
 		exec([f,&r](const Args &... args){ r = f(args...); }, args...);
 		return r;
 	}
+
+	template <typename F,typename In,typename R>
+	void exec_batch(F f, const std::vector<In> &in, std::vector<R> &out)
+	{
+		ITERATION_DATA &actual_stack = st.ACTUAL_STACK;
+		std::vector<batch_context> ctx(in.size());
+		std::vector<std::size_t> todo, retry;
+		for (std::size_t i = 0; i < in.size(); i++) {
+			ctx[i].prec_step = actual_stack.prec_step;
+			todo.push_back(i);
+		}
+		while (!todo.empty()) {
+			for (std::size_t i : todo) {
+				batch_enter(ctx[i]);
+
+				int p_end = 0;
+				bool done = false;
+				try {
+					out[i] = f(in[i]);
+					if (iRRAM_unlikely(st.reiterate_pending))
+						p_end = actual_stack.actual_prec + st.pending_prec_diff;
+					else
+						done = !st.infinite;
+				} catch (const Iteration &it) {
+					p_end = actual_stack.actual_prec + it.prec_diff;
+				} catch (const iRRAM_Numerical_Exception &exc) {
+					/* not handled by run::exec_batch */
+					cerr << "iRRAM exception: "
+					     << iRRAM_error_msg[exc.type] << "\n";
+					batch_leave(ctx[i], true, 0);
+					throw;
+				} catch (...) {
+					/* hand the run's own context back */
+					batch_leave(ctx[i], true, 0);
+					throw;
+				}
+
+				batch_leave(ctx[i], done, p_end);
+				if (!done)
+					retry.push_back(i);
+			}
+			todo.swap(retry);
+			retry.clear();
+		}
+	}
 };
 }
 
+/*! \ingroup exec
+ * \brief Evaluate `f(args...)`, reiterating at higher precisions until all
+ * of its multi-valued operations succeed. */
 template <typename F, typename... Args>
 ret_value_t<F,Args...> exec(F f, const Args &... args)
 {
@@ -135,6 +231,356 @@ ret_void_t<F,Args...> exec(F f, const Args &... args)
 	internal::run(*state).exec(f, args...);
 }
 
+/*! \brief Keeps the set-up of exec() alive for many calls.
+ *
+ * Each exec() allocates the multi-valued caches and sets the rounding mode
+ * of the FPU, which dominates the cost of computations taking only a few
+ * microseconds. A session does this once; its exec() only clears the
+ * caches, keeping their capacity, between the calls:
+ *
+ *     session s;
+ *     for (const auto &x : inputs)
+ *         results.push_back(s.exec(f, x));
+ *
+ * The session belongs to the thread that created it. It restores the
+ * previous rounding mode when destroyed, and the rounding mode must not be
+ * changed while it is alive. Like for exec(), the MPFR pools and the
+ * values of pi and ln2 are kept in the state of the thread anyway. */
+class session {
+	state_t &st;
+	mv_cache *cache_address;
+	int saved_round;
+public:
+	session();
+	~session();
+	session(const session &) = delete;
+	session & operator=(const session &) = delete;
+
+	template <typename F, typename... Args>
+	ret_value_t<F,Args...> exec(F f, const Args &... args)
+	{
+		return internal::run(st, cache_address).exec(f, args...);
+	}
+
+	template <typename F, typename... Args>
+	ret_void_t<F,Args...> exec(F f, const Args &... args)
+	{
+		internal::run(st, cache_address).exec(f, args...);
+	}
+
+	/*! \brief exec_batch() using the set-up of this session */
+	template <typename F, typename In>
+	std::vector<ret_value_t<F,In>> exec_batch(F f, const std::vector<In> &in)
+	{
+		std::vector<ret_value_t<F,In>> out(in.size());
+		internal::run(st, cache_address).exec_batch(f, in, out);
+		return out;
+	}
+};
+
+/*! \brief exec() for each of the inputs, sharing one reiteration loop.
+ *
+ * The inputs are evaluated one after the other at the current precision
+ * step. The ones that succeed leave the batch; only the failing ones are
+ * evaluated again, each at its own next precision step, until all of them
+ * succeeded. The set-up of exec() is done once, as for a \ref session, and
+ * the multi-valued cache of the batch is reused between the inputs; only
+ * inputs that have to be reiterated get a cache of their own.
+ *
+ * Output to iRRAM::cout is done in the order the inputs succeed.
+ * \return the vector of `f(in[i])` */
+template <typename F, typename In>
+std::vector<ret_value_t<F,In>> exec_batch(F f, const std::vector<In> &in)
+{
+	session s;
+	return s.exec_batch(f, in);
+}
+
+namespace internal {
+
+/* hides the context of the enclosing exec() from a sub_exec() */
+class sub_exec_scope {
+	state_t &st;
+	mv_cache *cache_address;
+	checkpoint_list *checkpoints;
+	long long requests, outputs;
+	ITERATION_DATA stack;
+	bool inReiterate, reiterate_pending;
+	int pending_level, pending_prec_diff, pending_count;
+public:
+	explicit sub_exec_scope(state_t &st);
+	~sub_exec_scope();
+	sub_exec_scope(const sub_exec_scope &) = delete;
+	sub_exec_scope & operator=(const sub_exec_scope &) = delete;
+};
+
+}
+
+/*! \brief Compute `f(args...)` with a reiteration loop of its own.
+ *
+ * `f` is evaluated like by exec(), starting at the first precision step with
+ * fresh multi-valued caches, until its result is known with an error of
+ * at most 2^(tol-2). Reiterations inside of `f` thus do not affect the
+ * precision of the enclosing computation. The result is a REAL with an
+ * error bound of 2^(tol-1), covering also the rounding of that result.
+ *
+ * For the enclosing computation, sub_exec() is a multi-valued operation
+ * like approx(): in its later iterations, the result is taken from the
+ * cache and `f` is not evaluated again. Inside of limits, `f` is evaluated
+ * each time. Hence the error of the result does not decrease when the
+ * enclosing computation reiterates; `tol` has to be small enough for it.
+ *
+ * If the error of `f(args...)` stops decreasing for a few iterations
+ * before reaching `tol`, the arguments are too imprecise for `tol`. The
+ * iterations of `f` are then abandoned and the enclosing computation is
+ * reiterated at a higher precision.
+ *
+ * `f` should not produce output. Use \ref use_ladder around the call for
+ * another precision ladder of the sub-problem. */
+template <typename F, typename... Args>
+REAL sub_exec(int tol, F f, const Args &... args)
+{
+	state_t &st = *state;
+	DYADIC d;
+	if (internal::sub_exec_cached(d, st))
+		return internal::sub_exec_result(d, tol);
+	internal::sub_exec_progress progress;
+	try {
+		internal::sub_exec_scope scope(st);
+		d = internal::run(st).exec([&]() {
+			REAL y(f(args...));
+			progress.check(y, tol);
+			return approx(y, tol - 1);
+		});
+	} catch (const internal::sub_exec_imprecise &e) {
+		/* only a higher precision of the arguments helps */
+		iRRAM_REITERATE(e.prec_diff);
+	}
+	internal::sub_exec_cache(d, st);
+	return internal::sub_exec_result(d, tol);
+}
+
+/*! \defgroup budgets Resource budgets
+ * \brief exec() with limits on time, memory and precision.
+ *
+ * exec_bounded() and exec_enclosure() stop the computation as soon as one
+ * of the given exec_limits is exceeded, instead of climbing the precision
+ * ladder without bound. The time and the memory are checked at each
+ * multi-valued operation and between iterations. The memory used is
+ * estimated from the number of MPFR numbers in use and the current
+ * precision; an iteration is not started if the numbers of the previous one
+ * would not fit at the next precision.
+ * @{ */
+
+template <typename R>
+struct bounded_result {
+	exec_status status;
+	R value; /*!< only valid if `status == exec_status::success` */
+};
+
+/*! \brief A ball around `center` with radius `error` containing the exact
+ * result, if `valid`. */
+struct enclosure {
+	exec_status status;
+	bool valid = false;
+	DYADIC center;
+	sizetype error;
+};
+
+namespace internal {
+class limits_scope {
+	state_t &st;
+	const exec_limits *saved;
+	std::chrono::steady_clock::time_point saved_deadline;
+	int saved_peak;
+public:
+	limits_scope(state_t &st, const exec_limits &l)
+	: st(st), saved(st.limits), saved_deadline(st.deadline)
+	, saved_peak(st.limits_peak_vars)
+	{
+		st.limits = &l;
+		st.deadline = std::chrono::steady_clock::now() +
+		              std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+		                      std::chrono::duration<double>(l.seconds));
+		st.limits_peak_vars = 0;
+	}
+	~limits_scope()
+	{
+		st.limits = saved;
+		st.deadline = saved_deadline;
+		st.limits_peak_vars = saved_peak;
+	}
+	limits_scope(const limits_scope &) = delete;
+	limits_scope & operator=(const limits_scope &) = delete;
+};
+}
+
+/*! \brief exec() within the budgets given by `l`.
+ *
+ * \return the status and, on success, the result of `f(args...)` */
+template <typename F, typename... Args>
+bounded_result<ret_value_t<F,Args...>>
+exec_bounded(const exec_limits &l, F f, const Args &... args)
+{
+	state_t &st = *state;
+	bounded_result<ret_value_t<F,Args...>> r;
+	internal::limits_scope scope(st, l);
+	try {
+		r.value = internal::run(st).exec(f, args...);
+		r.status = exec_status::success;
+	} catch (const exec_limit_exceeded &e) {
+		r.status = e.status;
+	}
+	return r;
+}
+
+/*! \brief Approximate the REAL `f(args...)` to an error of at most 2^p
+ * within the budgets given by `l`.
+ *
+ * Each iteration in which `f` returned is a candidate for the result; when a
+ * budget is exceeded, the tightest enclosure obtained so far is returned.
+ * On success, the error of the enclosure is at most 2^p. */
+template <typename F, typename... Args>
+enclosure exec_enclosure(const exec_limits &l, int p, F f, const Args &... args)
+{
+	state_t &st = *state;
+	enclosure r;
+	internal::limits_scope scope(st, l);
+	try {
+		internal::run(st).exec([&]() {
+			REAL x = f(args...);
+			DYADIC c;
+			sizetype e;
+			{
+				single_valued code;
+				x.to_formal_ball(c, e);
+			}
+			if (!r.valid || sizetype_less(e, r.error)) {
+				r.valid = true;
+				r.center = c;
+				r.error = e;
+			}
+			if (sizetype_less(sizetype_power2(p), e))
+				iRRAM_REITERATE(p - e.exponent);
+		});
+		r.status = exec_status::success;
+	} catch (const exec_limit_exceeded &e) {
+		r.status = e.status;
+	}
+	return r;
+}
+
+/*! @} */
+
+/*! \brief exec() that survives a restart of the program.
+ *
+ * After each failed iteration, the choices taken by multi-valued operations,
+ * the next precision step and the number of outputs made so far are written
+ * to the file `path`. If `path` holds such a dump when exec_persistent() is
+ * called, the computation resumes from it: it starts at the stored
+ * precision step, replays the stored choices and does not repeat output.
+ * The file is removed once `f` succeeded.
+ *
+ * A dump can be used by the same program on the same kind of machine only,
+ * and only if `f` and `args` are the same. Input, output to other streams
+ * than iRRAM::cout and checkpoints are not stored; if input or output
+ * streams have been opened, no dump is written. */
+template <typename F, typename... Args>
+ret_value_t<F,Args...> exec_persistent(const char *path, F f, const Args &... args)
+{
+	internal::run r(*state);
+	r.persist(path);
+	ret_value_t<F,Args...> v = r.exec(f, args...);
+	std::remove(path);
+	return v;
+}
+
+template <typename F, typename... Args>
+ret_void_t<F,Args...> exec_persistent(const char *path, F f, const Args &... args)
+{
+	internal::run r(*state);
+	r.persist(path);
+	r.exec(f, args...);
+	std::remove(path);
+}
+
+/*! \brief Write the state of the running exec() to `path`.
+ *
+ * To be called between iterations, see exec_persistent().
+ * \return false on I/O errors or if the state cannot be stored */
+bool dump_exec_state(const char *path);
+
+/*! \brief Load the state written by dump_exec_state() into the running exec().
+ * \return the precision step to continue with, or 0 if `path` could not
+ *         be read or does not hold a valid dump */
+int restore_exec_state(const char *path);
+
+/*! \defgroup precision_memory Precision memory
+ * \brief Warm starts for repeated exec() calls.
+ *
+ * exec_learned() works like exec(), but starts at the precision step the
+ * last call with the same key succeeded with, minus a small hysteresis
+ * (state_t::prec_memory.hysteresis steps), instead of at `--prec_start`.
+ * The key is either a user given tag or, without it, the type of the
+ * function object, i.e. a call site when lambdas are used.
+ * The table is thread-specific; it may be stored in and loaded from a file
+ * to survive a restart of the program. Only tags and lambda types are
+ * stable across runs of the same executable.
+ * @{ */
+
+namespace internal {
+int  precision_memory_start(state_t &st, const std::string &key);
+void precision_memory_learn(const run &r, const std::string &key, int start_step);
+
+template <typename F>
+std::string call_site_key(const F &) { return typeid(F).name(); }
+
+template <typename R,typename... Args>
+std::string call_site_key(R (*const &f)(Args...))
+{
+	char buf[2 * sizeof(void *) + 4];
+	snprintf(buf, sizeof(buf), "@%p", reinterpret_cast<void *>(f));
+	return typeid(f).name() + std::string(buf);
+}
+}
+
+template <typename F, typename... Args>
+ret_value_t<F,Args...> exec_learned(const std::string &tag, F f, const Args &... args)
+{
+	state_t &st = *state;
+	int start = internal::precision_memory_start(st, tag);
+	internal::run r(st, start);
+	ret_value_t<F,Args...> v = r.exec(f, args...);
+	internal::precision_memory_learn(r, tag, start);
+	return v;
+}
+
+template <typename F, typename... Args>
+ret_void_t<F,Args...> exec_learned(const std::string &tag, F f, const Args &... args)
+{
+	state_t &st = *state;
+	int start = internal::precision_memory_start(st, tag);
+	internal::run r(st, start);
+	r.exec(f, args...);
+	internal::precision_memory_learn(r, tag, start);
+}
+
+template <typename F, typename... Args>
+auto exec_learned(F f, const Args &... args) -> decltype(exec(f, args...))
+{
+	return exec_learned(internal::call_site_key(f), f, args...);
+}
+
+/*! \brief Write the precision memory of this thread to `path`.
+ * \return false on I/O errors */
+bool save_precision_memory(const char *path);
+
+/*! \brief Merge the table stored in `path` into this thread's precision memory.
+ * \return false if the file could not be read */
+bool load_precision_memory(const char *path);
+
+/*! @} */
+
 } // namespace iRRAM
 
 #endif /* ! iRRAM_LIB_H */
@@ -246,6 +246,7 @@ auto limit(F f, const ContArgs &... cont_args)
 			iRRAM_DEBUG2(2,"trying to compute general limit_gen1 "
 			               "with precicion 2^(%d)...\n", element);
 			limnew = f(element,cont_args...);
+			reiteration_point();
 			limnew_error = sizetype_add_power2(geterror(limnew), element);
 			if (firsttime == 2)
 				if (limnew_error.exponent > env.saved_prec(-1)
@@ -255,7 +256,7 @@ auto limit(F f, const ContArgs &... cont_args)
 						limnew_error.mantissa,
 						limnew_error.exponent);
 					element_step = 1;
-					element = 4+iRRAM_prec_array[element_step];
+					element = 4+state->prec_array[element_step];
 					firsttime = 1;
 				}
 			if (firsttime != 0 ||
@@ -271,7 +272,7 @@ auto limit(F f, const ContArgs &... cont_args)
 			if (element <= env.saved_prec())
 				break;
 			element_step += 4;
-			element = iRRAM_prec_array[element_step];
+			element = state->prec_array[element_step];
 		} catch (const Iteration &it) {
 			if (firsttime == 0) {
 				iRRAM_DEBUG1(2,"computation failed, using best success\n");
@@ -279,7 +280,7 @@ auto limit(F f, const ContArgs &... cont_args)
 			} else if (firsttime == 2) {
 				iRRAM_DEBUG1(2,"computation failed, trying normal p-sequence\n");
 				element_step = 1;
-				element = 4+iRRAM_prec_array[element_step];
+				element = 4+state->prec_array[element_step];
 				firsttime = 1;
 			} else {
 				iRRAM_DEBUG1(1,"computation of general limit_gen1 failed totally\n");
@@ -311,6 +312,7 @@ auto limit(F f, const DiscArgs &... disc_args)
 		try {
 			iRRAM_DEBUG2(2,"trying to compute general limit_0 with precision %d...\n",actual_stack().actual_prec);
 			lim = f(env.saved_prec(), disc_args...);
+			reiteration_point();
 			lim_error = geterror(lim);
 			iRRAM_DEBUG2(2,"getting result with local error %d*2^(%d)\n", lim_error.mantissa, lim_error.exponent);
 			break;
@@ -356,6 +358,7 @@ RESULT limit_mv (RESULT (*f)(int prec,
    try {
     iRRAM_DEBUG2(2,"trying to compute limit_mv with precicion 2^(%d)...\n",element);
     limnew=f(element,&choice,x);
+    reiteration_point();
     modify_cached(choice);
     element_error = sizetype_power2(element);
     limnew.geterror(limnew_error);
@@ -365,7 +368,7 @@ RESULT limit_mv (RESULT (*f)(int prec,
     iRRAM_DEBUG0(2,{fprintf(stderr,"computation not precise enough (%d*2^%d), trying normal p-sequence\n",
                    limnew_error.mantissa,limnew_error.exponent);});
        element_step=1;
-       element=4+iRRAM_prec_array[element_step];
+       element=4+state->prec_array[element_step];
        firsttime=1;
     }}
      catch ( Iteration it) {
@@ -376,7 +379,7 @@ RESULT limit_mv (RESULT (*f)(int prec,
       if ( firsttime==2) {
       iRRAM_DEBUG1(2,"computation failed, trying normal p-sequence\n");
       element_step=1;
-      element=4+iRRAM_prec_array[element_step];
+      element=4+state->prec_array[element_step];
       firsttime=1;
       } else {
       iRRAM_DEBUG1(1,"computation of limit_gen1 failed totally\n");
@@ -393,7 +396,7 @@ RESULT limit_mv (RESULT (*f)(int prec,
     firsttime=0;
     if (element<=env.saved_prec())break;
     element_step+=4;
-    element=iRRAM_prec_array[element_step];
+    element=state->prec_array[element_step];
     }
   lim.seterror(lim_error);
   iRRAM_DEBUG0(2,{fprintf(stderr,"end of limit_mv with error %d*2^(%d)\n",
@@ -426,6 +429,7 @@ RESULT  limit_lip (RESULT  (*f)(int,const ARGUMENT&,DISCRETE param),
      try{
       iRRAM_DEBUG2(2,"trying to compute limit_lip with precision %d...\n",actual_stack().actual_prec);
     lim=f(env.saved_prec(),x_new,param);
+    reiteration_point();
     lim.geterror(lim_error);
     if (lim_error.exponent > env.saved_prec()) {
       env.inc_step(2);
@@ -536,7 +540,7 @@ RESULT lipschitz_1p_1a (RESULT (*f)(const DISCRETE_ARGUMENT&, const PARAM& param
 
   while (try_it) {
     try { try_it=false;
-        lip_result=f(x_center,param); }
+        lip_result=f(x_center,param); reiteration_point(); }
     catch ( Iteration it)  { try_it=true;
       env.inc_step(2);
       iRRAM_DEBUG2(2,"lipschitz_1p_1a failed, increasing precision locally to step %d...\n",actual_stack().prec_step);
@@ -0,0 +1,128 @@
+/*
+
+iRRAM/speculative.h -- exec() racing several precision levels on threads
+
+This file is part of the iRRAM Library.
+
+The iRRAM Library is free software; you can redistribute it and/or modify
+it under the terms of the GNU Library General Public License as published by
+the Free Software Foundation; either version 2 of the License, or (at your
+option) any later version.
+
+The iRRAM Library is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Library General Public
+License for more details.
+
+You should have received a copy of the GNU Library General Public License
+along with the iRRAM Library; see the file COPYING.LIB.  If not, write to
+the Free Software Foundation, Inc., 59 Temple Place - Suite 330, Boston,
+MA 02111-1307, USA.
+*/
+
+/* This header is not included by iRRAM/lib.h as it requires linking with
+ * the thread library of the system (e.g. -pthread). */
+
+#ifndef iRRAM_SPECULATIVE_H
+#define iRRAM_SPECULATIVE_H
+
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <vector>
+#include <memory>
+#include <sstream>
+#include <exception>
+
+#include <iRRAM/lib.h>
+
+namespace iRRAM {
+
+namespace internal {
+
+inline unsigned speculative_threads()
+{
+	unsigned n = std::thread::hardware_concurrency();
+	return n < 2 ? 2 : n > 8 ? 8 : n;
+}
+
+}
+
+/*! \ingroup exec
+ * \brief exec() on several threads at once, each one starting at a different
+ * precision step.
+ *
+ * With n threads, thread i starts at step `prec_start + 4*i` and on a
+ * reiteration advances by `4*n` steps, so together they walk the same ladder
+ * as exec() does, but in parallel. The first thread to finish decides the
+ * result, the others are cancelled at their next multi-valued operation.
+ *
+ * Each thread uses its own state, i.e. its own caches and MPFR pools.
+ * Therefore `f` must be safe to call concurrently. The settings of the
+ * calling thread that decide how exec() iterates are taken over, among them
+ * the precision ladder, the double-double tier, deferred reiterations, the
+ * cache limit and the budgets of an enclosing exec_bounded().
+ * The output to iRRAM::cout is buffered per thread; only the one of the
+ * winning thread is written to the target of the caller's iRRAM::cout.
+ */
+template <typename F, typename... Args>
+ret_value_t<F,Args...> exec_speculative(F f, const Args &... args)
+{
+	typedef ret_value_t<F,Args...> R;
+
+	const state_t &parent = *state;
+	const int prec_start = parent.prec_start;
+	const unsigned n = internal::speculative_threads();
+
+	std::atomic<bool> done(false);
+	std::mutex m;
+	std::unique_ptr<R> result;
+	std::exception_ptr error;
+	std::string output;
+
+	auto worker = [&](unsigned i) {
+		state_t &st = *state;
+		copy_exec_settings(st, parent);
+		st.cancel = &done;
+		std::ostringstream buf;
+		iRRAM::cout.target = &buf;
+		try {
+			std::unique_ptr<R> r(new R(internal::run(st, prec_start + 4*i, 4*n).exec(f, args...)));
+			std::lock_guard<std::mutex> lock(m);
+			if (!done.exchange(true)) {
+				result = std::move(r);
+				output = buf.str();
+			}
+		} catch (const exec_cancelled &) {
+		} catch (...) {
+			std::lock_guard<std::mutex> lock(m);
+			if (!done.exchange(true))
+				error = std::current_exception();
+		}
+		iRRAM::cout.target = &std::cout;
+		st.cancel = nullptr;
+		iRRAM_finalize();
+	};
+
+	std::vector<std::thread> threads;
+	for (unsigned i = 0; i < n; i++)
+		threads.emplace_back(worker, i);
+	for (std::thread &t : threads)
+		t.join();
+
+	if (error)
+		std::rethrow_exception(error);
+	iRRAM::cout.target->write(output.data(), output.size());
+	iRRAM::cout.target->flush();
+	return std::move(*result);
+}
+
+template <typename F, typename... Args>
+ret_void_t<F,Args...> exec_speculative(F f, const Args &... args)
+{
+	exec_speculative([&f](const Args &... a){ f(a...); return 0; }, args...);
+}
+
+} // namespace iRRAM
+
+#endif /* ! iRRAM_SPECULATIVE_H */
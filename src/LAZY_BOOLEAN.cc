@@ -35,10 +35,13 @@ namespace iRRAM {
 
 LAZY_BOOLEAN::operator bool() const {
   bool result;
+  cancellation_point();
   if (!get_cached(result)){
 
     if ( value <= LAZY_BOOLEAN::BOTTOM ){
       iRRAM_DEBUG1(1,"lazy boolean values BOTTOM leading to iteration\n");
+      if (defer_reiteration(0))
+        return false;
       iRRAM_REITERATE(0);
     }
 
@@ -62,6 +65,7 @@ std::size_t choose(std::initializer_list<LAZY_BOOLEAN> x)
 	using std::find_if;
 
 	std::size_t result;
+	cancellation_point();
 	if (get_cached(result))
 		return result;
 
@@ -75,6 +79,8 @@ std::size_t choose(std::initializer_list<LAZY_BOOLEAN> x)
 		result = true_pos - begin(x);
 	} else if (find_if(begin(x), end(x), is_bot) != end(x)) {
 		iRRAM_DEBUG1(1,"choose(init-list): lazy boolean value BOTTOM leading to iteration\n");
+		if (defer_reiteration(0))
+			return 0;
 		iRRAM_REITERATE(0);
 	} else {
 		result = 0;
@@ -87,6 +93,7 @@ std::size_t choose(std::initializer_list<LAZY_BOOLEAN> x)
 int choose(const std::vector<LAZY_BOOLEAN>& x)
 {
   int result=0;
+  cancellation_point();
   //if( (ACTUAL_STACK.inlimit==0) && iRRAM_thread_data_address->cache_i.get(result)) return result;
   if (get_cached(result))
     return result;
@@ -110,6 +117,8 @@ int choose(const std::vector<LAZY_BOOLEAN>& x)
 
   if ( minvalue == LAZY_BOOLEAN::BOTTOM ){
     iRRAM_DEBUG1(1,"lazy boolean value BOTTOM leading to iteration\n");
+    if (defer_reiteration(0))
+      return 0;
     iRRAM_REITERATE(0);
   }
 
@@ -126,6 +135,7 @@ int choose(const LAZY_BOOLEAN& x1,
            const LAZY_BOOLEAN& x6)
 {
   int result=0;
+  cancellation_point();
   if (get_cached(result))
     return result;
 
@@ -145,6 +155,8 @@ int choose(const LAZY_BOOLEAN& x1,
 
   if ( minvalue == LAZY_BOOLEAN::BOTTOM ){
     iRRAM_DEBUG1(1,"lazy boolean value BOTTOM leading to iteration\n");
+    if (defer_reiteration(0))
+      return 0;
     iRRAM_REITERATE(0);
   }
 
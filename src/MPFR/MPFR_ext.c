@@ -14,7 +14,8 @@ void ext_mpfr_initialize(struct iRRAM_ext_mpfr_cache_t *cache)
 void ext_mpfr_finalize(struct iRRAM_ext_mpfr_cache_t *cache)
 {
 	for (size_t i=cache->free_var_count; i; i--) {
-		mpfr_clear(cache->free_vars[i-1]);
+		if (!ext_mpfr_is_inline(cache->free_vars[i-1]))
+			mpfr_clear(cache->free_vars[i-1]);
 		free(cache->free_vars[i-1]);
 		cache->total_freed_var_count++;
 	}
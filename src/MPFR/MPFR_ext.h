@@ -72,6 +72,9 @@ int ext_mpfr_size(const mpfr_t z);
 void ext_mpfr_add(const mpfr_t z1,const mpfr_t z2,mpfr_t z,int p);
 void ext_mpfr_sub(const mpfr_t z1,const mpfr_t z2,mpfr_t z,int p);
 void ext_mpfr_mul(const mpfr_t z1,const mpfr_t z2,mpfr_t z,int p);
+void ext_mpfr_fma(const mpfr_t z1,const mpfr_t z2,const mpfr_t z3,mpfr_t z,int p);
+void ext_mpfr_fms(const mpfr_t z1,const mpfr_t z2,const mpfr_t z3,mpfr_t z,int p);
+void ext_mpfr_fmma(const mpfr_t z1,const mpfr_t z2,const mpfr_t z3,const mpfr_t z4,mpfr_t z,int p);
 void ext_mpfr_div(const mpfr_t z1,const mpfr_t z2,mpfr_t z,int p);
 void ext_mpfr_abs(const mpfr_t z1,mpfr_t z);
 void ext_mpfr_truncate(const mpfr_t z1,mpfr_t z);
@@ -92,6 +95,7 @@ void ext_mpfr_write(const mpfr_t z,int w);
 
 void ext_mpfr_duplicate_w_init(const mpfr_t z1,mpfr_ptr *z2);
 void ext_mpfr_duplicate_wo_init(const mpfr_t z1,mpfr_t z2);
+void ext_mpfr_copy(const mpfr_t z1,mpfr_t z,int p);
 
 void ext_mpfr_sqrt(const mpfr_t z1,mpfr_t z,int p);
 void ext_mpfr_shift(const mpfr_t z1,mpfr_t z,int p);
@@ -145,13 +149,22 @@ inline void ext_mpfr_getsize(const mpfr_t z,ext_mpfr_sizetype* s)
   }
 }
 
+/* The precision of the result z of an operation on z1 and z2: q, unless z is
+ * one of the operands, then its value is kept and only a larger q is taken,
+ * so the result is still rounded once and at least to q bits. */
+inline void ext_mpfr_result_prec(mpfr_t z,int q,const mpfr_t z1,const mpfr_t z2)
+{
+  if (z != z1 && z != z2) ext_mpfr_set_prec(z,q);
+  else if (q > mpfr_get_prec(z)) ext_mpfr_raise_prec(z,q);
+}
+
 inline void ext_mpfr_add(const mpfr_t z1,const mpfr_t z2,mpfr_t z,int p)
 { int q,s1,s2;
   s1=ext_mpfr_size(z1);
   s2=ext_mpfr_size(z2);
   q=MAX_OF(s1,s2)-p+1;
   q=MAX_OF(q,10);
-  mpfr_set_prec(z,q);
+  ext_mpfr_result_prec(z,q,z1,z2);
   mpfr_add(z,z1,z2,iRRAM_mpfr_rounding_mode);
   ext_mpfr_remove_trailing_zeroes (z); 
   return;
@@ -163,7 +176,7 @@ inline void ext_mpfr_add_i(const mpfr_t z1,int n,mpfr_t z,int p)
   	s1=ext_mpfr_size(z1);
 	q=MAX_OF(s1,s2)-p+1;
 	q=MAX_OF(q,10);
-	mpfr_set_prec(z,q);
+	ext_mpfr_result_prec(z,q,z1,z1);
 	if(n<0)mpfr_sub_ui(z,z1,-n,iRRAM_mpfr_rounding_mode);
 		else mpfr_add_ui(z,z1,n,iRRAM_mpfr_rounding_mode);
 	return;
@@ -176,7 +189,7 @@ inline void ext_mpfr_sub(const mpfr_t z1,const mpfr_t z2,mpfr_t z,int p)
   s2=ext_mpfr_size(z2);
   q=MAX_OF(s1,s2)-p+1;
   q=MAX_OF(q,10);
-  mpfr_set_prec(z,q);
+  ext_mpfr_result_prec(z,q,z1,z2);
   mpfr_sub(z,z1,z2,iRRAM_mpfr_rounding_mode);
   ext_mpfr_remove_trailing_zeroes (z); 
  return;
@@ -188,7 +201,7 @@ inline void ext_mpfr_sub_i(const mpfr_t z1,int n,mpfr_t z,int p)
   	s1=ext_mpfr_size(z1);
 	q=MAX_OF(s1,BITS_PER_MP_LIMB)-p+1;
 	q=MAX_OF(q,10);
-	mpfr_set_prec(z,q);
+	ext_mpfr_result_prec(z,q,z1,z1);
 	if(n<0)mpfr_add_ui(z,z1,-n,iRRAM_mpfr_rounding_mode);
 		else mpfr_sub_ui(z,z1,n,iRRAM_mpfr_rounding_mode);
 	return;
@@ -200,7 +213,7 @@ inline void ext_mpfr_i_sub(int z1,const mpfr_t z2,mpfr_t z,int p)
   	s2=ext_mpfr_size(z2);
 	q=MAX_OF(BITS_PER_MP_LIMB,s2)-p+1;
   	q=MAX_OF(q,10);
-  	mpfr_set_prec(z,q);
+  	ext_mpfr_result_prec(z,q,z2,z2);
   	if(z1<0){mpfr_add_ui(z,z2,-z1,iRRAM_mpfr_rounding_mode);mpfr_neg(z,z,iRRAM_mpfr_rounding_mode);} 
 	else mpfr_ui_sub(z,z1,z2,iRRAM_mpfr_rounding_mode);
   	return;
@@ -212,12 +225,61 @@ inline void ext_mpfr_mul(const mpfr_t z1,const mpfr_t z2,mpfr_t z,int p)
   s2=ext_mpfr_size(z2);
   q=s1+s2-p+1;
   q=MAX_OF(q,10);
-  mpfr_set_prec(z,q);
+  ext_mpfr_result_prec(z,q,z1,z2);
   mpfr_mul(z,z1,z2,iRRAM_mpfr_rounding_mode);
   ext_mpfr_remove_trailing_zeroes (z); 
   return;
 }
 
+/* z1*z2+z3 and z1*z2-z3 rounded once, the precision as for the sum */
+inline void ext_mpfr_fma(const mpfr_t z1,const mpfr_t z2,const mpfr_t z3,mpfr_t z,int p)
+{ int q,s12,s3;
+  s12=ext_mpfr_size(z1)+ext_mpfr_size(z2);
+  s3=ext_mpfr_size(z3);
+  q=MAX_OF(s12,s3)-p+1;
+  q=MAX_OF(q,10);
+  ext_mpfr_set_prec(z,q);
+  mpfr_fma(z,z1,z2,z3,iRRAM_mpfr_rounding_mode);
+  ext_mpfr_remove_trailing_zeroes (z); 
+  return;
+}
+
+inline void ext_mpfr_fms(const mpfr_t z1,const mpfr_t z2,const mpfr_t z3,mpfr_t z,int p)
+{ int q,s12,s3;
+  s12=ext_mpfr_size(z1)+ext_mpfr_size(z2);
+  s3=ext_mpfr_size(z3);
+  q=MAX_OF(s12,s3)-p+1;
+  q=MAX_OF(q,10);
+  ext_mpfr_set_prec(z,q);
+  mpfr_fms(z,z1,z2,z3,iRRAM_mpfr_rounding_mode);
+  ext_mpfr_remove_trailing_zeroes (z); 
+  return;
+}
+
+/* z1*z2+z3*z4 rounded once; before MPFR 4 with the exact products */
+inline void ext_mpfr_fmma(const mpfr_t z1,const mpfr_t z2,const mpfr_t z3,const mpfr_t z4,mpfr_t z,int p)
+{ int q,s12,s34;
+  s12=ext_mpfr_size(z1)+ext_mpfr_size(z2);
+  s34=ext_mpfr_size(z3)+ext_mpfr_size(z4);
+  q=MAX_OF(s12,s34)-p+1;
+  q=MAX_OF(q,10);
+  ext_mpfr_set_prec(z,q);
+#if MPFR_VERSION_MAJOR >= 4
+  mpfr_fmma(z,z1,z2,z3,z4,iRRAM_mpfr_rounding_mode);
+#else
+  mpfr_t a,b;
+  mpfr_init2(a,mpfr_get_prec(z1)+mpfr_get_prec(z2));
+  mpfr_init2(b,mpfr_get_prec(z3)+mpfr_get_prec(z4));
+  mpfr_mul(a,z1,z2,GMP_RNDN);
+  mpfr_mul(b,z3,z4,GMP_RNDN);
+  mpfr_add(z,a,b,iRRAM_mpfr_rounding_mode);
+  mpfr_clear(a);
+  mpfr_clear(b);
+#endif
+  ext_mpfr_remove_trailing_zeroes (z); 
+  return;
+}
+
 inline void ext_mpfr_mul_i(const mpfr_t z1, int z2, mpfr_t z, int p)
 {
 int q,s1,zz,maxsize_ifexact;
@@ -225,7 +287,7 @@ s1=ext_mpfr_size(z1);
 q=s1+BITS_PER_MP_LIMB-p+10;if(q<10)q=10;
 maxsize_ifexact=mpfr_get_prec(z1)+32;
 if (q>maxsize_ifexact)q= maxsize_ifexact;
-mpfr_set_prec(z,q);
+ext_mpfr_result_prec(z,q,z1,z1);
 if (z2<0) zz=-z2; else zz=z2;
 mpfr_mul_ui(z,z1,zz,iRRAM_mpfr_rounding_mode);
 if (z2<0)mpfr_neg(z,z,iRRAM_mpfr_rounding_mode);
@@ -238,7 +300,7 @@ inline void ext_mpfr_div(const mpfr_t z1,const mpfr_t z2,mpfr_t z,int p)
   s2=ext_mpfr_size(z2);
   q=s1-s2-p+1;
   q=MAX_OF(q,10);
-  mpfr_set_prec(z,q);
+  ext_mpfr_result_prec(z,q,z1,z2);
   mpfr_div(z,z1,z2,iRRAM_mpfr_rounding_mode);
   ext_mpfr_remove_trailing_zeroes (z); 
   return;
@@ -250,7 +312,7 @@ inline void ext_mpfr_div_i(const mpfr_t z1,int z2,mpfr_t z,int p)
   	s1=ext_mpfr_size(z1);
   	q=s1-s2-p+10;
   	q=MAX_OF(q,10);
-  	mpfr_set_prec(z,q);
+  	ext_mpfr_result_prec(z,q,z1,z1);
 	if(z2<0)zz=-z2;else zz=z2;
   	mpfr_div_ui(z,z1,zz,iRRAM_mpfr_rounding_mode);
 	if(z2<0)mpfr_neg(z,z,iRRAM_mpfr_rounding_mode);
@@ -263,7 +325,7 @@ inline void ext_mpfr_i_div(int z1,const mpfr_t z2,mpfr_t z,int p)
   	s2=ext_mpfr_size(z2);
   	q=BITS_PER_MP_LIMB-s2-p+10;
   	q=MAX_OF(q,10);
-  	mpfr_set_prec(z,q);
+  	ext_mpfr_result_prec(z,q,z2,z2);
 	if(z1<0)zz=-z1;else zz=z1;
   	mpfr_ui_div(z,zz,z2,iRRAM_mpfr_rounding_mode);
 	if(z1<0)mpfr_neg(z,z,iRRAM_mpfr_rounding_mode);
@@ -273,7 +335,7 @@ inline void ext_mpfr_i_div(int z1,const mpfr_t z2,mpfr_t z,int p)
 inline void ext_mpfr_abs(const mpfr_t z1,mpfr_t z)
 {
   int q1=mpfr_get_prec(z1);
-  mpfr_set_prec(z,q1);
+  ext_mpfr_set_prec(z,q1);
   mpfr_abs(z,z1,iRRAM_mpfr_rounding_mode);
   return;
 }
@@ -281,7 +343,7 @@ inline void ext_mpfr_abs(const mpfr_t z1,mpfr_t z)
 inline void ext_mpfr_truncate(const mpfr_t z1,mpfr_t z)
 {
   int q1=mpfr_get_prec(z1);
-  mpfr_set_prec(z,q1);
+  ext_mpfr_set_prec(z,q1);
   mpfr_trunc(z,z1);
   return;
 }
@@ -425,16 +487,28 @@ inline void ext_mpfr_write(const mpfr_t z,int w)
 inline void ext_mpfr_duplicate_wo_init(const mpfr_t z1,mpfr_t z2)
 {
   int q1=mpfr_get_prec(z1);
-  if (mpfr_get_prec(z2)< q1) mpfr_set_prec(z2,q1);
+  if (mpfr_get_prec(z2)< q1) ext_mpfr_set_prec(z2,q1);
   mpfr_set(z2,z1,iRRAM_mpfr_rounding_mode);
 }
 
+/* z1 rounded to a multiple of 2^p, with just the bits needed for that */
+inline void ext_mpfr_copy(const mpfr_t z1,mpfr_t z,int p)
+{ int q;
+  if (!mpfr_regular_p(z1)) { ext_mpfr_duplicate_wo_init(z1,z); return; }
+  q=ext_mpfr_size(z1)-p;
+  if (q >= mpfr_get_prec(z1)) { ext_mpfr_duplicate_wo_init(z1,z); return; }
+  q=MAX_OF(q,10);
+  ext_mpfr_set_prec(z,q);
+  mpfr_set(z,z1,iRRAM_mpfr_rounding_mode);
+  ext_mpfr_remove_trailing_zeroes (z);
+}
+
 inline void ext_mpfr_sqrt(const mpfr_t z1,mpfr_t z,int p)
 { int q,s1;
   s1=ext_mpfr_size(z1);
   q=s1/2-p+1;
   q=MAX_OF(q,10);
-  mpfr_set_prec(z,q);
+  ext_mpfr_set_prec(z,q);
   mpfr_sqrt(z,z1,iRRAM_mpfr_rounding_mode);
   ext_mpfr_remove_trailing_zeroes (z); 
   return;
@@ -442,7 +516,7 @@ inline void ext_mpfr_sqrt(const mpfr_t z1,mpfr_t z,int p)
 
 inline void ext_mpfr_shift(const mpfr_t z1,mpfr_t z,int n)
 {
-  mpfr_set_prec(z,mpfr_get_prec(z1));
+  ext_mpfr_result_prec(z,mpfr_get_prec(z1),z1,z1);
   if ( n>=  0 ) mpfr_mul_2exp(z,z1,n,iRRAM_mpfr_rounding_mode);
   else mpfr_div_2exp(z,z1,-n,iRRAM_mpfr_rounding_mode);
   return;
@@ -451,7 +525,7 @@ inline void ext_mpfr_shift(const mpfr_t z1,mpfr_t z,int n)
 inline void ext_mpfr_set_z(mpfr_t r,int_mpfr_type i)
 {
   int sib=mpz_sizeinbase(i,2);
-  mpfr_set_prec(r,MAX_OF(32,sib));
+  ext_mpfr_set_prec(r,MAX_OF(32,sib));
   mpfr_set_z(r,i,iRRAM_mpfr_rounding_mode);
 } 
 
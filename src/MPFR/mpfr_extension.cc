@@ -33,7 +33,7 @@ typedef  DYADIC (DYADIC_function) (const DYADIC &,const int &);
 
 inline void mpfr_wrapper(DYADIC_function f, mpfr_ptr r, mpfr_srcptr u,int p){
   DYADIC arg,res;
-  mpfr_set_prec(arg.value,mpfr_get_prec(u));
+  ext_mpfr_set_prec(arg.value,mpfr_get_prec(u));
   mpfr_set(arg.value,u,__gmp_default_rounding_mode);
   res = exec(f,arg,p);
   mpfr_set_prec(r,mpfr_get_prec(res.value));
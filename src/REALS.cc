@@ -22,6 +22,7 @@ the Free Software Foundation, Inc., 59 Temple Place - Suite 330, Boston,
 MA 02111-1307, USA. 
 */
 
+#include <algorithm>
 #include <cstdlib>
 #include <cstdarg>
 #include <cstring>
@@ -87,42 +88,64 @@ MA 02111-1307, USA.
 
 namespace iRRAM {
 
+/* the exact sum of the doubles d[0], ..., d[n-1] */
+static MP_type mp_sum(const double *d, int n)
+{
+	MP_type z, t, s;
+	MP_init(z);
+	MP_double_to_mp(d[0], z);
+	if (n == 1)
+		return z;
+	MP_init(t);
+	MP_init(s);
+	for (int i = 1; i < n; i++) {
+		MP_double_to_mp(d[i], t);
+		// all doubles are multiples of 2^-1074, so this is exact
+		MP_add(z, t, s, -1150);
+		std::swap(z, s);
+	}
+	MP_clear(t);
+	MP_clear(s);
+	return z;
+}
+
 void REAL::mp_make_mp()
 {
-	if (!std::isfinite(dp.upper_neg) || !std::isfinite(dp.lower_pos))
+	const internal::dd_pair b = dd_interval();
+	if (!std::isfinite(b.lower_pos.hi) || !std::isfinite(b.upper_neg.hi) ||
+	    !std::isfinite(b.lower_pos.lo) || !std::isfinite(b.upper_neg.lo))
 		iRRAM_REITERATE(0);
-	if (dp.upper_neg == -dp.lower_pos) {
+	// rwidth <= x_L - x_U
+	double rwidth = dp.upper_neg + dp.lower_pos;
+	if (dd()) {
+		internal::double_double w =
+		        internal::dd_ops::add(b.lower_pos, b.upper_neg);
+		rwidth = w.hi + w.lo;
+	}
+	// error and vsize overlap the interval, which is in b now
+	dd_clear();
+	if (value)
+		MP_clear(value);
+	if (rwidth >= 0) {
 		// here we have a point interval...
-		if (!value)
-			MP_init(value);
-		MP_double_to_mp(dp.lower_pos, value);
+		const double d[] = { b.lower_pos.hi, b.lower_pos.lo };
+		value = mp_sum(d, b.lower_pos.lo ? 2 : 1);
 		error = sizetype_exact();
 	} else {
 		// now we know that it is not a point interval:
+		const double d[] = { b.lower_pos.hi, -b.upper_neg.hi,
+		                     b.lower_pos.lo, -b.upper_neg.lo };
+		MP_type value2 = mp_sum(d, b.lower_pos.lo || b.upper_neg.lo ? 4 : 2);
 		MP_init(value);
-		MP_double_to_mp(dp.lower_pos, value);
-		MP_type value1;
-		MP_init(value1);
-		MP_double_to_mp(-dp.upper_neg, value1);
-		MP_type value2;
-		MP_init(value2);
-		MP_add(value, value1, value2, -1150);
 		MP_shift(value2, value, -1);
-		MP_clear(value1);
 		MP_clear(value2);
-		// value0 differs from precise result (lower+upper)/2 by at most
-		// 2^{-1200},
-		// which is sufficiently more precise than all bits even of the
-		// smallest double number (2^-1075), so here the error is as
-		// small as reasonable
-		double rwidth = (dp.upper_neg + dp.lower_pos);
+		// value is the exact center (x_L+x_U)/2
 		int e;
 		unsigned m = (unsigned)ldexp(frexp(-rwidth, &e), 30) + 2;
-		// Here, the "+2" accounts for the possible truncation error and
-		// the error on the computation of cvalue.
-		/* round to -\infty => dp.upper-dp.lower <= -rwidth <= m*2^(e-30) */
-		// So we have that the interval (dp.lower,dp.upper) is a subset
-		// of the interval (cvalue - m*2^(e-29),cvalue + m*2^(e-29))
+		// Here, the "+2" accounts for the possible truncation error.
+		/* round to -\infty => x_U-x_L <= -rwidth <= m*2^(e-30) */
+		// So we have that the interval (x_L,x_U) is a subset
+		// of the interval (value - m*2^(e-29),value + m*2^(e-29))
 		error = sizetype_normalize({m, e - 29});
 	}
 	MP_getsize(value, vsize);
@@ -140,6 +163,7 @@ void REAL::mp_from_mp(const REAL & y)
 	double wd = ldexp(-double(y.error.mantissa), y.error.exponent);
 	dp.upper_neg = nextafter(-center, -INFINITY) + wd;
 	dp.lower_pos = nextafter(center, -INFINITY) + wd;
+	dd_clear();
 }
 
 void REAL::mp_from_int(const int i)
@@ -167,83 +191,345 @@ void REAL::mp_copy(const REAL & y)
 
 void REAL::mp_copy_init(const REAL & y)
 {
+	dd_clear();
 	MP_duplicate_w_init(y.value, value);
 	error = y.error;
 	vsize = y.vsize;
 }
 
-REAL REAL::mp_addition(const REAL & y) const
+/* The following compute x+y, x-y, n-x, x*y and x/y into z, which may also
+ * be the value of an operand, and return the error of z. */
+
+static sizetype mp_add(MP_type z, const REAL & x, const REAL & y)
 {
-	MP_type zvalue;
 	sizetype zerror;
 	int local_prec;
 	const auto &stack = actual_stack();
 	if (stack.prec_policy == 0)
-		local_prec = max({y.error.exponent, this->error.exponent,
+		local_prec = max({y.error.exponent, x.error.exponent,
 		                  stack.actual_prec});
 	else {
-		local_prec = max(this->vsize.exponent, y.vsize.exponent);
-		local_prec = max({y.error.exponent, this->error.exponent,
+		local_prec = max(x.vsize.exponent, y.vsize.exponent);
+		local_prec = max({y.error.exponent, x.error.exponent,
 		                  local_prec - 50 + stack.actual_prec});
 	}
-	MP_init(zvalue);
-	MP_mv_add(this->value, y.value, zvalue, local_prec);
-
-	sizetype_add_wo_norm(zerror, this->error, y.error);
-	zerror = sizetype_add_power2(zerror, local_prec);
-
-	return REAL(zvalue, zerror);
+	sizetype_add_wo_norm(zerror, x.error, y.error);
+	MP_mv_add(x.value, y.value, z, local_prec);
+	return sizetype_add_power2(zerror, local_prec);
 }
 
-REAL REAL::mp_addition(const int n) const
+static sizetype mp_add(MP_type z, const REAL & x, const int n)
 {
-	MP_type zvalue;
-	sizetype zerror;
 	int local_prec = 0;
 	const auto &stack = actual_stack();
 	if (stack.prec_policy == 0)
-		local_prec = max(this->error.exponent, stack.actual_prec);
+		local_prec = max(x.error.exponent, stack.actual_prec);
 	else {
 		sizetype ysize;
 		ysize = sizetype_normalize({(unsigned)(n > 0 ? n : -n), 0});
-		local_prec = max(this->vsize.exponent, ysize.exponent);
-		local_prec = max(this->error.exponent,
+		local_prec = max(x.vsize.exponent, ysize.exponent);
+		local_prec = max(x.error.exponent,
 		                 local_prec - 50 + stack.actual_prec);
 	}
-	MP_init(zvalue);
-	MP_mv_addi(this->value, n, zvalue, local_prec);
-	zerror = sizetype_add_power2(this->error, local_prec);
-	return REAL(zvalue, zerror);
+	sizetype zerror = x.error;
+	MP_mv_addi(x.value, n, z, local_prec);
+	return sizetype_add_power2(zerror, local_prec);
 }
 
-REAL & REAL::mp_eqaddition(const REAL & y)
+static sizetype mp_sub(MP_type z, const REAL & x, const REAL & y)
 {
-	MP_type zvalue;
+	sizetype zerror;
 	int local_prec;
 	const auto &stack = actual_stack();
 	if (stack.prec_policy == 0)
-		local_prec = max({y.error.exponent, this->error.exponent,
+		local_prec = max({y.error.exponent, x.error.exponent,
 		                  stack.actual_prec});
 	else {
-		local_prec = max(this->vsize.exponent, y.vsize.exponent);
-		local_prec = max({y.error.exponent, this->error.exponent,
+		local_prec = max(x.vsize.exponent, y.vsize.exponent);
+		local_prec = max({y.error.exponent, x.error.exponent,
 		                  local_prec - 50 + stack.actual_prec});
 	}
+	sizetype_add_wo_norm(zerror, x.error, y.error);
+	MP_mv_sub(x.value, y.value, z, local_prec);
+	return sizetype_add_power2(zerror, local_prec);
+}
+
+static sizetype mp_sub(MP_type z, const REAL & x, const int n)
+{
+	int local_prec;
+	const auto &stack = actual_stack();
+	if (stack.prec_policy == 0)
+		local_prec = max(x.error.exponent, stack.actual_prec);
+	else {
+		sizetype ysize;
+		ysize = sizetype_normalize({(unsigned)(n > 0 ? n : -n), 0});
+		local_prec = max(x.vsize.exponent, ysize.exponent);
+		local_prec = max(x.error.exponent,
+		                 local_prec - 50 + stack.actual_prec);
+	}
+	sizetype zerror = x.error;
+	MP_mv_subi(x.value, n, z, local_prec);
+	return sizetype_add_power2(zerror, local_prec);
+}
+
+static sizetype mp_sub(MP_type z, const int n, const REAL & x)
+{
+	int local_prec;
+	const auto &stack = actual_stack();
+	if (stack.prec_policy == 0)
+		local_prec = max(x.error.exponent, stack.actual_prec);
+	else {
+		sizetype xsize, ysize;
+		MP_getsize(x.value, xsize);
+		ysize = sizetype_normalize({(unsigned)(n > 0 ? n : -n), 0});
+		local_prec = max(xsize.exponent, ysize.exponent);
+		local_prec = max(x.error.exponent,
+		                 local_prec - 50 + stack.actual_prec);
+	}
+	sizetype zerror = x.error;
+	MP_mv_isub(n, x.value, z, local_prec);
+	return sizetype_add_power2(zerror, local_prec);
+}
+
+static sizetype mp_mul(MP_type z, const REAL & x, const REAL & y)
+{
+	sizetype zerror, proderror, sumerror;
+	int local_prec;
+	zerror = x.vsize * y.error;
+	sizetype_add_wo_norm(sumerror, y.vsize, y.error);
+	proderror = sumerror * x.error;
+	zerror += proderror;
+	const auto &stack = actual_stack();
+	if (stack.prec_policy == 0)
+		local_prec = max(zerror.exponent, stack.actual_prec);
+	else
+		local_prec = max(zerror.exponent,
+		                 x.vsize.exponent + y.vsize.exponent - 50 +
+		                         stack.actual_prec);
+	MP_mv_mul(x.value, y.value, z, local_prec);
+	return sizetype_add_power2(zerror, local_prec);
+}
+
+static sizetype mp_mul(MP_type z, const REAL & x, const int n)
+{
+	sizetype zerror, ysize;
+	int local_prec;
+	ysize = sizetype_normalize({(unsigned)(n > 0 ? n : -n), 0});
+	zerror = ysize * x.error;
+
+	const auto &stack = actual_stack();
+	if (stack.prec_policy == 0)
+		local_prec = max(zerror.exponent, stack.actual_prec);
+	else
+		local_prec = max(zerror.exponent,
+		                 x.vsize.exponent + ysize.exponent - 50 +
+		                         stack.actual_prec);
+	MP_mv_muli(x.value, n, z, local_prec);
+	return sizetype_add_power2(zerror, local_prec);
+}
+
+static sizetype mp_div(MP_type z, const REAL & x, const REAL & y)
+{
+	sizetype zerror, h1, h2, h3;
+	int local_prec;
+	sizetype_half(h1, y.vsize);
+	if (sizetype_less(h1, y.error)) {
+		iRRAM_DEBUG2(1, "insufficient precision %d*2^(%d) in "
+		                "denominator of size %d*2^(%d)\n",
+		             y.error.mantissa, y.error.exponent,
+		             y.vsize.mantissa, y.vsize.exponent);
+		iRRAM_REITERATE(0);
+	}
+	h1 = x.vsize * y.error;
+	h2 = y.vsize * x.error;
+	h1 += h2;
+	h3 = y.vsize;
+	sizetype_dec(h3);
+	sizetype_dec(h3, y.error);
+	h2 = h3 * y.vsize;
+	sizetype_div(zerror, h1, h2);
+	const auto &stack = actual_stack();
+	if (stack.prec_policy == 0)
+		local_prec = max(zerror.exponent, stack.actual_prec);
+	else
+		local_prec = max(zerror.exponent,
+		                 x.vsize.exponent - y.vsize.exponent - 50 +
+		                         stack.actual_prec);
+	MP_mv_div(x.value, y.value, z, local_prec);
+	return sizetype_add_power2(zerror, local_prec);
+}
+
+static sizetype mp_div(MP_type z, const REAL & x, const int n)
+{
+	sizetype zerror, ysize;
+	int local_prec;
+	ysize = sizetype_normalize({(unsigned)(n > 0 ? n : -n), 0});
+	sizetype_div(zerror, x.error, ysize);
+	const auto &stack = actual_stack();
+	if (stack.prec_policy == 0)
+		local_prec = max(zerror.exponent, stack.actual_prec);
+	else
+		local_prec = max(zerror.exponent,
+		                 x.vsize.exponent - ysize.exponent - 50 +
+		                         stack.actual_prec);
+	MP_mv_divi(x.value, n, z, local_prec);
+	return sizetype_add_power2(zerror, local_prec);
+}
+
+REAL REAL::mp_addition(const REAL & y) const
+{
+	MP_type zvalue;
+	MP_init(zvalue);
+	sizetype zerror = mp_add(zvalue, *this, y);
+	return REAL(zvalue, zerror);
+}
+
+REAL REAL::mp_addition(const int n) const
+{
+	MP_type zvalue;
 	MP_init(zvalue);
-	MP_mv_add(this->value, y.value, zvalue, local_prec);
+	sizetype zerror = mp_add(zvalue, *this, n);
+	return REAL(zvalue, zerror);
+}
+
+REAL REAL::mp_subtraction(const REAL & y) const
+{
+	MP_type zvalue;
+	MP_init(zvalue);
+	sizetype zerror = mp_sub(zvalue, *this, y);
+	return REAL(zvalue, zerror);
+}
+
+REAL REAL::mp_subtraction(const int n) const
+{
+	MP_type zvalue;
+	MP_init(zvalue);
+	sizetype zerror = mp_sub(zvalue, *this, n);
+	return REAL(zvalue, zerror);
+}
+
+REAL REAL::mp_invsubtraction(const int n) const
+{
+	MP_type zvalue;
+	MP_init(zvalue);
+	sizetype zerror = mp_sub(zvalue, n, *this);
+	return REAL(zvalue, zerror);
+}
+
+REAL REAL::mp_multiplication(const REAL & y) const
+{
+	MP_type zvalue;
+	MP_init(zvalue);
+	sizetype zerror = mp_mul(zvalue, *this, y);
+	return REAL(zvalue, zerror);
+}
 
-	this->error += y.error;
-	this->error = sizetype_add_power2(this->error, local_prec);
+REAL REAL::mp_multiplication(const int n) const
+{
+	MP_type zvalue;
+	MP_init(zvalue);
+	sizetype zerror = mp_mul(zvalue, *this, n);
+	return REAL(zvalue, zerror);
+}
+
+REAL REAL::mp_division(const REAL & y) const
+{
+	MP_type zvalue;
+	MP_init(zvalue);
+	sizetype zerror = mp_div(zvalue, *this, y);
+	return REAL(zvalue, zerror);
+}
+
+REAL REAL::mp_division(const int n) const
+{
+	MP_type zvalue;
+	MP_init(zvalue);
+	sizetype zerror = mp_div(zvalue, *this, n);
+	return REAL(zvalue, zerror);
+}
 
-	/*  zerror = sizetype_power2(local_prec);
-	  sizetype_inc2(this->error,y.error,zerror);*/
+/* In-place versions; the result replaces the value of *this, which has to
+ * be in MP form already. */
 
-	MP_clear(this->value);
-	this->value = zvalue;
-	MP_getsize(this->value, this->vsize);
-	return (*this);
+REAL & REAL::mp_eqaddition(const REAL & y)
+{
+	error = mp_add(value, *this, y);
+	MP_getsize(value, vsize);
+	return *this;
 }
 
+REAL & REAL::mp_eqaddition(const int n)
+{
+	error = mp_add(value, *this, n);
+	MP_getsize(value, vsize);
+	return *this;
+}
+
+REAL & REAL::mp_eqsubtraction(const REAL & y)
+{
+	error = mp_sub(value, *this, y);
+	MP_getsize(value, vsize);
+	return *this;
+}
+
+REAL & REAL::mp_eqsubtraction(const int n)
+{
+	error = mp_sub(value, *this, n);
+	MP_getsize(value, vsize);
+	return *this;
+}
+
+REAL & REAL::mp_eqinvsubtraction(const REAL & x)
+{
+	error = mp_sub(value, x, *this);
+	MP_getsize(value, vsize);
+	return *this;
+}
+
+REAL & REAL::mp_eqinvsubtraction(const int n)
+{
+	error = mp_sub(value, n, *this);
+	MP_getsize(value, vsize);
+	return *this;
+}
+
+REAL & REAL::mp_eqmultiplication(const REAL & y)
+{
+	error = mp_mul(value, *this, y);
+	MP_getsize(value, vsize);
+	return *this;
+}
+
+REAL & REAL::mp_eqmultiplication(const int n)
+{
+	error = mp_mul(value, *this, n);
+	MP_getsize(value, vsize);
+	return *this;
+}
+
+REAL & REAL::mp_eqdivision(const REAL & y)
+{
+	error = mp_div(value, *this, y);
+	MP_getsize(value, vsize);
+	return *this;
+}
+
+REAL & REAL::mp_eqdivision(const int n)
+{
+	error = mp_div(value, *this, n);
+	MP_getsize(value, vsize);
+	return *this;
+}
+
+REAL & REAL::mp_eqinvdivision(const REAL & x)
+{
+	error = mp_div(value, x, *this);
+	MP_getsize(value, vsize);
+	return *this;
+}
+
+
+
 std::string swrite(const REAL & x, const int w, const float_form form)
 {
 	if (!x.value) {
@@ -358,198 +644,95 @@ std::string swrite(const REAL & x, const int w, const float_form form)
 	return result;
 }
 
-REAL REAL::mp_subtraction(const REAL & y) const
-{
-	MP_type zvalue;
-	sizetype zerror;
-	int local_prec;
-	const auto &stack = actual_stack();
-	if (stack.prec_policy == 0)
-		local_prec = max({y.error.exponent, this->error.exponent,
-		                  stack.actual_prec});
-	else {
-		local_prec = max(this->vsize.exponent, y.vsize.exponent);
-		local_prec = max({y.error.exponent, this->error.exponent,
-		                  local_prec - 50 + stack.actual_prec});
-	}
-	MP_init(zvalue);
-	MP_mv_sub(this->value, y.value, zvalue, local_prec);
 
-	sizetype_add_wo_norm(zerror, this->error, y.error);
-	zerror = sizetype_add_power2(zerror, local_prec);
-	/*
-	  zerror = sizetype_power2(local_prec);
-	  sizetype_inc2(zerror,this->error,y.error);
-	*/
-	return REAL(zvalue, zerror);
-}
 
-REAL REAL::mp_subtraction(const int n) const
-{
-	MP_type zvalue;
-	sizetype zerror;
-	int local_prec;
-	const auto &stack = actual_stack();
-	if (stack.prec_policy == 0)
-		local_prec =
-		        max(this->error.exponent, stack.actual_prec);
-	else {
-		sizetype ysize;
-		ysize = sizetype_normalize({(unsigned)(n > 0 ? n : -n), 0});
-		local_prec = max(this->vsize.exponent, ysize.exponent);
-		local_prec = max(this->error.exponent,
-		                 local_prec - 50 + stack.actual_prec);
-	}
-	MP_init(zvalue);
-	MP_mv_subi(this->value, n, zvalue, local_prec);
-	zerror = sizetype_add_power2(this->error, local_prec);
-	return REAL(zvalue, zerror);
-}
 
-REAL REAL::mp_invsubtraction(const int n) const
-{
-	MP_type zvalue;
-	sizetype zerror;
-	int local_prec;
-	const auto &stack = actual_stack();
-	if (stack.prec_policy == 0)
-		local_prec = max(this->error.exponent, stack.actual_prec);
-	else {
-		sizetype xsize, ysize;
-		MP_getsize(this->value, xsize);
-		ysize = sizetype_normalize({(unsigned)(n > 0 ? n : -n), 0});
-		local_prec = max(xsize.exponent, ysize.exponent);
-		local_prec = max(this->error.exponent,
-		                 local_prec - 50 + stack.actual_prec);
-	}
-	MP_init(zvalue);
-	MP_mv_isub(n, this->value, zvalue, local_prec);
-	zerror = sizetype_add_power2(this->error, local_prec);
-	return REAL(zvalue, zerror);
-}
 
-REAL REAL::mp_multiplication(const REAL & y) const
+
+
+
+void rwrite(const REAL & x, const int w)  { cout << swrite(x, w, float_form::absolute); }
+void rwritee(const REAL & x, const int w) { cout << swrite(x, w, float_form::relative); }
+void rshow(const REAL & x, const int w)   { cout << swrite(x, w, float_form::show); }
+
+
+REAL REAL::mp_square() const
 {
 	MP_type zvalue;
-	sizetype zerror, proderror, sumerror;
+	sizetype zerror, proderror;
 	int local_prec;
-	zerror = this->vsize * y.error;
-	sizetype_add_wo_norm(sumerror, y.vsize, y.error);
-	proderror = sumerror * this->error;
+	zerror = this->vsize * this->error;
+	proderror = this->vsize * this->error;
+	zerror += proderror;
+	proderror = this->error * this->error;
 	zerror += proderror;
 	const auto &stack = actual_stack();
 	if (stack.prec_policy == 0)
 		local_prec = max(zerror.exponent, stack.actual_prec);
 	else
 		local_prec = max(zerror.exponent,
-		                 this->vsize.exponent + y.vsize.exponent - 50 +
-		                         stack.actual_prec);
+		                 this->vsize.exponent + this->vsize.exponent -
+		                         50 + stack.actual_prec);
 	MP_init(zvalue);
-	MP_mv_mul(this->value, y.value, zvalue, local_prec);
+	MP_mv_mul(this->value, this->value, zvalue, local_prec);
 	zerror = sizetype_add_power2(zerror, local_prec);
 	return REAL(zvalue, zerror);
 }
 
-REAL REAL::mp_multiplication(const int n) const
+/* The error of x*y as in mp_multiplication(), and the precision for adding
+ * a value of size zsize to it. */
+static int mp_product_error(const REAL &x, const REAL &y, sizetype zsize,
+                            sizetype &error)
 {
-	MP_type zvalue;
-	sizetype zerror, ysize;
-	int local_prec;
-	ysize = sizetype_normalize({(unsigned)(n > 0 ? n : -n), 0});
-	zerror = ysize * this->error;
-
+	sizetype sumerror, proderror;
+	error = x.vsize * y.error;
+	sizetype_add_wo_norm(sumerror, y.vsize, y.error);
+	proderror = sumerror * x.error;
+	error += proderror;
 	const auto &stack = actual_stack();
 	if (stack.prec_policy == 0)
-		local_prec = max(zerror.exponent, stack.actual_prec);
-	else
-		local_prec = max(zerror.exponent,
-		                 this->vsize.exponent + ysize.exponent - 50 +
-		                         stack.actual_prec);
-	MP_init(zvalue);
-	MP_mv_muli(this->value, n, zvalue, local_prec);
-	zerror = sizetype_add_power2(zerror, local_prec);
-	return REAL(zvalue, zerror);
+		return stack.actual_prec;
+	return max(x.vsize.exponent + y.vsize.exponent, zsize.exponent) - 50 +
+	       stack.actual_prec;
 }
 
-REAL REAL::mp_division(const REAL & y) const
+REAL REAL::mp_fma(const REAL & y, const REAL & z) const
 {
 	MP_type zvalue;
-	sizetype zerror, h1, h2, h3;
-	int local_prec;
-	sizetype_half(h1, y.vsize);
-	if (sizetype_less(h1, y.error)) {
-		iRRAM_DEBUG2(1, "insufficient precision %d*2^(%d) in "
-		                "denominator of size %d*2^(%d)\n",
-		             y.error.mantissa, y.error.exponent,
-		             y.vsize.mantissa, y.vsize.exponent);
-		iRRAM_REITERATE(0);
-	}
-	h1 = this->vsize * y.error;
-	h2 = y.vsize * this->error;
-	h1 += h2;
-	h3 = y.vsize;
-	sizetype_dec(h3);
-	sizetype_dec(h3, y.error);
-	h2 = h3 * y.vsize;
-	sizetype_div(zerror, h1, h2);
-	const auto &stack = actual_stack();
-	if (stack.prec_policy == 0)
-		local_prec = max(zerror.exponent, stack.actual_prec);
-	else
-		local_prec = max(zerror.exponent,
-		                 this->vsize.exponent - y.vsize.exponent - 50 +
-		                         stack.actual_prec);
+	sizetype zerror;
+	int local_prec = mp_product_error(*this, y, z.vsize, zerror);
+	zerror += z.error;
+	local_prec = max(zerror.exponent, local_prec);
 	MP_init(zvalue);
-	MP_mv_div(this->value, y.value, zvalue, local_prec);
+	MP_mv_fma(this->value, y.value, z.value, zvalue, local_prec);
 	zerror = sizetype_add_power2(zerror, local_prec);
 	return REAL(zvalue, zerror);
 }
 
-REAL REAL::mp_division(const int n) const
+REAL REAL::mp_fms(const REAL & y, const REAL & z) const
 {
 	MP_type zvalue;
-	sizetype zerror, ysize;
-	int local_prec;
-	ysize = sizetype_normalize({(unsigned)(n > 0 ? n : -n), 0});
-	sizetype_div(zerror, this->error, ysize);
-	const auto &stack = actual_stack();
-	if (stack.prec_policy == 0)
-		local_prec = max(zerror.exponent, stack.actual_prec);
-	else
-		local_prec = max(zerror.exponent,
-		                 this->vsize.exponent - ysize.exponent - 50 +
-		                         stack.actual_prec);
+	sizetype zerror;
+	int local_prec = mp_product_error(*this, y, z.vsize, zerror);
+	zerror += z.error;
+	local_prec = max(zerror.exponent, local_prec);
 	MP_init(zvalue);
-	MP_mv_divi(this->value, n, zvalue, local_prec);
+	MP_mv_fms(this->value, y.value, z.value, zvalue, local_prec);
 	zerror = sizetype_add_power2(zerror, local_prec);
 	return REAL(zvalue, zerror);
 }
 
-
-void rwrite(const REAL & x, const int w)  { cout << swrite(x, w, float_form::absolute); }
-void rwritee(const REAL & x, const int w) { cout << swrite(x, w, float_form::relative); }
-void rshow(const REAL & x, const int w)   { cout << swrite(x, w, float_form::show); }
-
-
-REAL REAL::mp_square() const
+REAL REAL::mp_fmma(const REAL & b, const REAL & c, const REAL & d) const
 {
 	MP_type zvalue;
-	sizetype zerror, proderror;
-	int local_prec;
-	zerror = this->vsize * this->error;
-	proderror = this->vsize * this->error;
-	zerror += proderror;
-	proderror = this->error * this->error;
-	zerror += proderror;
-	const auto &stack = actual_stack();
-	if (stack.prec_policy == 0)
-		local_prec = max(zerror.exponent, stack.actual_prec);
-	else
-		local_prec = max(zerror.exponent,
-		                 this->vsize.exponent + this->vsize.exponent -
-		                         50 + stack.actual_prec);
+	sizetype zerror, cderror, cdsize;
+	cdsize = c.vsize * d.vsize;
+	int local_prec = mp_product_error(*this, b, cdsize, zerror);
+	mp_product_error(c, d, cdsize, cderror);
+	zerror += cderror;
+	local_prec = max(zerror.exponent, local_prec);
 	MP_init(zvalue);
-	MP_mv_mul(this->value, this->value, zvalue, local_prec);
+	MP_mv_fmma(this->value, b.value, c.value, d.value, zvalue, local_prec);
 	zerror = sizetype_add_power2(zerror, local_prec);
 	return REAL(zvalue, zerror);
 }
@@ -577,6 +760,136 @@ REAL REAL::mp_absval() const
 	return REAL(zvalue, error);
 }
 
+/* double-double intervals, see REAL::dd */
+
+static internal::dd_pair dd_int(const int n)
+{
+	return { { double(n), 0.0 }, { -double(n), 0.0 } };
+}
+
+REAL REAL::dd_addition(const REAL & y) const
+{
+	return REAL(internal::dd_ops::add(dd_interval(), y.dd_interval()));
+}
+
+REAL REAL::dd_addition(const int n) const
+{
+	return REAL(internal::dd_ops::add(dd_interval(), dd_int(n)));
+}
+
+REAL REAL::dd_subtraction(const REAL & y) const
+{
+	return REAL(internal::dd_ops::sub(dd_interval(), y.dd_interval()));
+}
+
+REAL REAL::dd_subtraction(const int n) const
+{
+	return REAL(internal::dd_ops::sub(dd_interval(), dd_int(n)));
+}
+
+REAL REAL::dd_invsubtraction(const int n) const
+{
+	return REAL(internal::dd_ops::sub(dd_int(n), dd_interval()));
+}
+
+REAL REAL::dd_multiplication(const REAL & y) const
+{
+	return REAL(internal::dd_ops::mul(dd_interval(), y.dd_interval()));
+}
+
+REAL REAL::dd_multiplication(const int n) const
+{
+	return REAL(internal::dd_ops::mul(dd_interval(), dd_int(n)));
+}
+
+REAL REAL::dd_division(const REAL & y) const
+{
+	internal::dd_pair z;
+	if (!internal::dd_ops::div(z, dd_interval(), y.dd_interval()))
+		return mp_conv().mp_division(y.mp_conv()); // containing zero...
+	return REAL(z);
+}
+
+REAL REAL::dd_division(const int n) const
+{
+	internal::dd_pair z;
+	if (!internal::dd_ops::div(z, dd_interval(), dd_int(n)))
+		return mp_conv().mp_division(n); // division by zero...
+	return REAL(z);
+}
+
+REAL REAL::dd_square() const
+{
+	return REAL(internal::dd_ops::square(dd_interval()));
+}
+
+REAL REAL::dd_absval() const
+{
+	return REAL(internal::dd_ops::abs(dd_interval()));
+}
+
+/* the compound assignments update the interval in place */
+
+REAL & REAL::dd_eqaddition(const REAL & y)
+{
+	dd_set(internal::dd_ops::add(dd_interval(), y.dd_interval()));
+	return *this;
+}
+
+REAL & REAL::dd_eqsubtraction(const REAL & y)
+{
+	dd_set(internal::dd_ops::sub(dd_interval(), y.dd_interval()));
+	return *this;
+}
+
+REAL & REAL::dd_eqsubtraction(const int n)
+{
+	dd_set(internal::dd_ops::sub(dd_interval(), dd_int(n)));
+	return *this;
+}
+
+REAL & REAL::dd_eqmultiplication(const REAL & y)
+{
+	dd_set(internal::dd_ops::mul(dd_interval(), y.dd_interval()));
+	return *this;
+}
+
+REAL & REAL::dd_eqmultiplication(const int n)
+{
+	dd_set(internal::dd_ops::mul(dd_interval(), dd_int(n)));
+	return *this;
+}
+
+REAL & REAL::dd_eqdivision(const REAL & y)
+{
+	internal::dd_pair z;
+	if (!internal::dd_ops::div(z, dd_interval(), y.dd_interval()))
+		return mp_conv().mp_eqdivision(y.mp_conv()); // containing zero...
+	dd_set(z);
+	return *this;
+}
+
+REAL & REAL::dd_eqdivision(const int n)
+{
+	internal::dd_pair z;
+	if (!internal::dd_ops::div(z, dd_interval(), dd_int(n)))
+		return mp_conv().mp_eqdivision(n); // division by zero...
+	dd_set(z);
+	return *this;
+}
+
+LAZY_BOOLEAN REAL::dd_less(const REAL & y) const
+{
+	using internal::dd_ops::add;
+	using internal::dd_ops::positive;
+	const internal::dd_pair a = dd_interval(), b = y.dd_interval();
+	if (positive(add(b.lower_pos, a.upper_neg))) // x_U < y_L
+		return true;
+	if (positive(add(a.lower_pos, b.upper_neg))) // x_L > y_U
+		return false;
+	return LAZY_BOOLEAN::BOTTOM;
+}
+
 // REAL REAL::mp_interval_join (const REAL& y)const
 // {
 // /* The purpose of this routine is to compute interval hull (as a simplified
@@ -604,13 +917,44 @@ REAL REAL::mp_absval() const
 
 /*****************************************************/
 
+/* For the double intervals the functions below work on
+ * inf|x| <= sup|x|, both exact. Non-finite bounds take the MP path, which
+ * reiterates. */
+static bool dp_abs_bounds(const REAL & x, double &inf, double &sup)
+{
+	if (x.value || x.dd())
+		return false;
+	double l = x.dp.lower_pos, n = x.dp.upper_neg;
+	sup = std::max(std::fabs(l), std::fabs(n));
+	inf = l > 0 ? l : n > 0 ? n : 0.0;
+	return sup <= DBL_MAX;
+}
+
+/* 2^(e-1) <= a < 2^e for a > 0, comparisons with 2^k for any k go by e as
+ * 2^k may not be a double */
+static int dp_exponent(double a)
+{
+	int e;
+	std::frexp(a, &e);
+	return e;
+}
+
 REAL scale(const REAL & x, int n)
 {
 	if (!x.value) {
+		if (!x.dd()) {
+			/* exact unless the bounds leave the range of double,
+			 * then rounded down */
+			REAL::double_pair z(std::ldexp(x.dp.lower_pos, n),
+			                    std::ldexp(x.dp.upper_neg, n));
+			if (std::isfinite(z.lower_pos) &&
+			    std::isfinite(z.upper_neg))
+				return REAL(z);
+		}
 		/* TODO: huh? why not x.mp_conv()? For instance
 		 * operator+(const REAL &, const REAL &) does the same */
 		REAL y(x);
-		return scale(y.mp_conv(), n);
+		return scale(std::move(y.mp_conv()), n);
 	}
 	sizetype zerror;
 	MP_type zvalue;
@@ -621,9 +965,35 @@ REAL scale(const REAL & x, int n)
 	return REAL(zvalue, zerror);
 }
 
+REAL scale(REAL && x, int n)
+{
+	if (!x.value)
+		return scale(static_cast<const REAL &>(x), n);
+	MP_shift(x.value, x.value, n);
+	x.error = x.error << n;
+	MP_getsize(x.value, x.vsize);
+	return std::move(x);
+}
+
 
 LAZY_BOOLEAN positive(const REAL & x, int k)
 {
+	double inf, sup;
+	if (dp_abs_bounds(x, inf, sup)) {
+		/* as for MP: the sign of the center if the radius is at most
+		 * 2^k or 0 is not contained */
+		const double l = x.dp.lower_pos, n = x.dp.upper_neg;
+		if (inf > 0 || l == -n)
+			return l > 0;
+		/* rounded up, > 2^(k+1) or close to it */
+		double w = -(n + l);
+		if (w > 0 && dp_exponent(w) > k + 1) {
+			iRRAM_DEBUG2(1, "insufficient precision [%g,%g] in test "
+			                "on positive\n", l, -n);
+			return LAZY_BOOLEAN::BOTTOM;
+		}
+		return l > n;
+	}
 	if (!x.value) {
 		REAL y(x);
 		return positive(y.mp_conv(), k);
@@ -660,27 +1030,64 @@ DYADIC approx(const REAL & x, const int p)
 {
 	if (!x.value)
 		return approx(REAL(x).mp_conv(), p);
-	MP_type result;
-	MP_type erg;
-	if (get_cached(result)) {
-		MP_duplicate_w_init(result, erg);
-		return DYADIC(erg);
-	}
+	cancellation_point();
+	DYADIC result;
+	if (get_cached(result))
+		return result;
 
 	if (sizetype_less(sizetype_power2(p + 1), x.error)) {
 		iRRAM_DEBUG2(1,
 		             "insufficient precision %d*2^(%d) in approx(%d)\n",
 		             x.error.mantissa, x.error.exponent, p);
-		iRRAM_REITERATE(p - x.error.exponent);
+		if (!defer_reiteration(p - x.error.exponent))
+			iRRAM_REITERATE(p - x.error.exponent);
 	}
-	MP_init(erg);
-	MP_copy(x.value, erg, p - 1);
+	MP_copy(x.value, result.value, p - 1);
 
-	if (actual_stack().inlimit == 0) { /* TODO: make state_t::put_cached lambda-aware */
-		MP_duplicate_w_init(erg, result);
-		put_cached(result);
+	put_cached(result);
+	return result;
+}
+
+/* sub_exec() is multi-valued like approx() */
+bool internal::sub_exec_cached(DYADIC &d, const state_t &st)
+{
+	return get_cached(d, st);
+}
+
+void internal::sub_exec_cache(const DYADIC &d, const state_t &st)
+{
+	put_cached(d, st);
+}
+
+void internal::sub_exec_progress::check(const REAL &y, int tol)
+{
+	sizetype e;
+	y.geterror(e);
+	int err = sizetype_log2(e);
+	if (err < tol - 1)
+		return;
+	if (err < least_error) {
+		least_error = err;
+		stalls = 0;
+	} else if (++stalls >= sub_exec_max_stalls) {
+		iRRAM_DEBUG2(1, "sub_exec: error stays at 2^%d, "
+		                "the arguments are too imprecise\n", err);
+		throw sub_exec_imprecise{ tol - 1 - err };
 	}
-	return DYADIC(erg);
+	/* still shrinking: the next step of the inner ladder may reach tol */
+	iRRAM_DEBUG2(1, "sub_exec: error 2^%d exceeds 2^%d\n", err, tol - 2);
+	if (!defer_reiteration(tol - 1 - err))
+		iRRAM_REITERATE(tol - 1 - err);
+}
+
+/* check() leaves f(args...) with an error of at most 2^(tol-2) and
+ * approx(y, tol-1) rounds it to a multiple of 2^(tol-2), so d is within
+ * 2^(tol-1) of the true value */
+REAL internal::sub_exec_result(const DYADIC &d, int tol)
+{
+	REAL r(d);
+	r.adderror(sizetype_power2(tol - 1));
+	return r;
 }
 
 /*!
@@ -718,8 +1125,30 @@ DYADIC approx(const REAL & x, const int p)
  */
 int size(const REAL & x)
 {
+	double inf, sup;
+	if (dp_abs_bounds(x, inf, sup)) {
+		cancellation_point();
+		int result = 0;
+		if (get_cached(result))
+			return result;
+		if (sup == 0)
+			throw iRRAM_Numerical_Exception(iRRAM_underflow_error);
+		/* 2^(result-1) <= sup < 2^result */
+		result = dp_exponent(sup);
+		/* inf < 2^(result-2) */
+		if (inf == 0 || dp_exponent(inf) <= result - 2) {
+			iRRAM_DEBUG2(1, "insufficient precision [%g,%g] in size\n",
+			             x.dp.lower_pos, -x.dp.upper_neg);
+			if (defer_reiteration(0))
+				return result;
+			iRRAM_REITERATE(0);
+		}
+		put_cached(result);
+		return result;
+	}
 	if (!x.value)
 		return size(REAL(x).mp_conv());
+	cancellation_point();
 	int result = 0;
 	if (get_cached(result))
 		return result;
@@ -737,6 +1166,8 @@ int size(const REAL & x)
 		        "insufficient precision %d*2^(%d) in size %d*2^(%d)\n",
 		        x.error.mantissa, x.error.exponent, x.vsize.mantissa,
 		        x.vsize.exponent);
+		if (defer_reiteration(0))
+			return result;
 		iRRAM_REITERATE(0);
 	}
 
@@ -746,11 +1177,24 @@ int size(const REAL & x)
 
 int upperbound(const REAL & x)
 {
+	int result;
+	double inf, sup;
+	if (dp_abs_bounds(x, inf, sup)) {
+		if (get_cached(result))
+			return result;
+		/* as for MP: |x| < 2^(result+1), the exponent of 0 for x = 0 */
+		if (sup == 0) {
+			result = sizetype_exact().exponent;
+		} else {
+			result = dp_exponent(sup) - 1;
+		}
+		put_cached(result);
+		return result;
+	}
 	if (!x.value) {
 		REAL y(x);
 		return upperbound(y.mp_conv());
 	}
-	int result;
 	sizetype ergsize;
 	if (get_cached(result))
 		return result;
@@ -803,6 +1247,17 @@ int upperbound(const REAL & x)
  */
 LAZY_BOOLEAN bound(const REAL & x, const int k)
 {
+	double inf, sup;
+	if (dp_abs_bounds(x, inf, sup)) {
+		/* T: |x| < 2^k, F: |x| >= 2^(k-1) */
+		if (sup == 0 || dp_exponent(sup) <= k)
+			return true;
+		if (inf > 0 && dp_exponent(inf) >= k)
+			return false;
+		iRRAM_DEBUG2(1, "insufficient precision [%g,%g] in bounding by "
+		                "2^(%d)\n", x.dp.lower_pos, -x.dp.upper_neg, k);
+		return LAZY_BOOLEAN::BOTTOM;
+	}
 	if (!x.value) {
 		REAL y(x);
 		return bound(y.mp_conv(), k);
@@ -825,7 +1280,11 @@ LAZY_BOOLEAN bound(const REAL & x, const int k)
 /*! \ingroup debug */
 void REAL::rcheck(int n) const
 {
-	if (!value) {
+	if (!value && dd()) {
+		REAL y(*this);
+		y.mp_make_mp();
+		y.rcheck(n);
+	} else if (!value) {
 		cerr << "Value: (" << std::setprecision(n) << std::setw(n)
 		     << dp.lower_pos << ";" << std::setprecision(n)
 		     << std::setw(n) << -dp.upper_neg << ")\n";
@@ -910,11 +1369,9 @@ INTEGER REAL::as_INTEGER() const
 	if (!this->value) {
 		return this->mp_conv().as_INTEGER();
 	}
-	MP_int_type result, value;
-	if (get_cached(result)) {
-		MP_int_duplicate_w_init(result, value);
-		return value;
-	}
+	INTEGER result;
+	if (get_cached(result))
+		return result;
 
 	sizetype psize;
 	sizetype_set(psize, 1, -4);
@@ -930,14 +1387,10 @@ INTEGER REAL::as_INTEGER() const
 		             this->error.mantissa, this->error.exponent);
 		iRRAM_REITERATE(-y.error.exponent);
 	}
-	MP_int_init(value);
-	MP_mp_to_INTEGER(y.value, value);
+	MP_mp_to_INTEGER(y.value, result.value);
 
-	if (actual_stack().inlimit == 0) { /* TODO: ... or duplicate the MP_*_types */
-		MP_int_duplicate_w_init(value, result);
-		put_cached(result);
-	}
-	return value;
+	put_cached(result);
+	return result;
 }
 
 // conversion to type REAL from smaller types
@@ -1053,7 +1506,7 @@ REAL strtoREAL2(const char *s, char **endptr)
 
 	MP_type value;
 	MP_init(value);
-	mpfr_set_prec(value, max(10, m+1));
+	ext_mpfr_set_prec(value, max(10, m+1));
 	int r = mpfr_strtofr(value, s, &mpfr_endptr, 10, MPFR_RNDN);
 	ext_mpfr_remove_trailing_zeroes(value);
 
@@ -1170,8 +1623,14 @@ REAL minimum (const REAL& x, const REAL& y){
 REAL abs(const std::vector<REAL>& x)
 {
 	unsigned int n=x.size();
-	REAL sqrsum=0;
-	for (unsigned i=0;i<n;i++) {
+	/* double intervals: accumulate without creating REALs, as
+	 * abs(const REALVECTOR &) does */
+	internal::double_pair s(0.0, 0.0);
+	unsigned i=0;
+	for (;i<n && x[i].dp_only();i++)
+		s = internal::dp_ops::add(s, internal::dp_ops::square(x[i].dp));
+	REAL sqrsum(s);
+	for (;i<n;i++) {
 		sqrsum += square(x[i]);
 	}
 	return sqrt(sqrsum);
@@ -1185,11 +1644,22 @@ DYADIC REAL::as_DYADIC() const { return approx(*this, DYADIC::getprec()); }
 // Conversion from REAL to double with a relative precision of p bits
 double REAL::as_double(const int p) const
 {
-	if (bound(*this, -1150))
-		return 0.0;
-	int s = size(*this);
-	DYADIC d = approx(*this, s - p - 2);
-	return MP_mp_to_double(d.value);
+	double result;
+	if (get_cached(result))
+		return result;
+	{
+		/* only the double is cached, not the choices leading to it */
+		single_valued code;
+		if (bound(*this, -1150)) {
+			result = 0.0;
+		} else {
+			int s = size(*this);
+			DYADIC d = approx(*this, s - p - 2);
+			result = MP_mp_to_double(d.value);
+		}
+	}
+	put_cached(result);
+	return result;
 }
 
 /*****************************************/
@@ -0,0 +1,400 @@
+/*
+
+REALVECTOR.cc -- routines for the REALVECTOR class
+
+This file is part of the iRRAM Library.
+
+The iRRAM Library is free software; you can redistribute it and/or modify
+it under the terms of the GNU Library General Public License as published by
+the Free Software Foundation; either version 2 of the License, or (at your
+option) any later version.
+
+The iRRAM Library is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Library General Public
+License for more details.
+
+You should have received a copy of the GNU Library General Public License
+along with the iRRAM Library; see the file COPYING.LIB.  If not, write to
+the Free Software Foundation, Inc., 59 Temple Place - Suite 330, Boston,
+MA 02111-1307, USA.
+*/
+
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+#include <iRRAM/REALVECTOR.h>
+
+namespace iRRAM {
+
+namespace {
+
+/* The kernels below run on packs of `width` doubles. As for double_pair, all
+ * bounds are rounded towards -infinity and the upper bound is negated. */
+struct pack_double {
+	typedef double type;
+	enum { width = 1 };
+	static type load(const double *p) { return *p; }
+	static void store(double *p, type v) { *p = v; }
+	static type set1(double d) { return d; }
+	static type zero() { return 0.0; }
+	static type add(type a, type b) { return a + b; }
+	static type mul(type a, type b) { return a * b; }
+	static type neg(type a) { return -a; }
+	static type abs(type a) { return std::fabs(a); }
+	/* like minpd and maxpd */
+	static type min(type a, type b) { return a < b ? a : b; }
+	static type max(type a, type b) { return a > b ? a : b; }
+	static double sum(type a) { return a; }
+};
+
+#ifdef iRRAM_HAVE_SSE2
+struct pack_sse2 {
+	typedef __m128d type;
+	enum { width = 2 };
+	static type load(const double *p) { return _mm_load_pd(p); }
+	static void store(double *p, type v) { _mm_store_pd(p, v); }
+	static type set1(double d) { return _mm_set1_pd(d); }
+	static type zero() { return _mm_setzero_pd(); }
+	static type add(type a, type b) { return _mm_add_pd(a, b); }
+	static type mul(type a, type b) { return _mm_mul_pd(a, b); }
+	static type neg(type a) { return _mm_xor_pd(a, _mm_set1_pd(-0.0)); }
+	static type abs(type a) { return _mm_andnot_pd(_mm_set1_pd(-0.0), a); }
+	static type min(type a, type b) { return _mm_min_pd(a, b); }
+	static type max(type a, type b) { return _mm_max_pd(a, b); }
+	static double sum(type a)
+	{
+		return _mm_cvtsd_f64(_mm_add_sd(a, _mm_unpackhi_pd(a, a)));
+	}
+};
+#endif
+
+#ifdef iRRAM_HAVE_AVX
+struct pack_avx {
+	typedef __m256d type;
+	enum { width = 4 };
+	static type load(const double *p) { return _mm256_load_pd(p); }
+	static void store(double *p, type v) { _mm256_store_pd(p, v); }
+	static type set1(double d) { return _mm256_set1_pd(d); }
+	static type zero() { return _mm256_setzero_pd(); }
+	static type add(type a, type b) { return _mm256_add_pd(a, b); }
+	static type mul(type a, type b) { return _mm256_mul_pd(a, b); }
+	static type neg(type a) { return _mm256_xor_pd(a, _mm256_set1_pd(-0.0)); }
+	static type abs(type a) { return _mm256_andnot_pd(_mm256_set1_pd(-0.0), a); }
+	static type min(type a, type b) { return _mm256_min_pd(a, b); }
+	static type max(type a, type b) { return _mm256_max_pd(a, b); }
+	static double sum(type a)
+	{
+		return pack_sse2::sum(_mm_add_pd(_mm256_castpd256_pd128(a),
+		                                 _mm256_extractf128_pd(a, 1)));
+	}
+};
+typedef pack_avx pack;
+#elif defined(iRRAM_HAVE_SSE2)
+typedef pack_sse2 pack;
+#else
+typedef pack_double pack;
+#endif
+
+typedef pack::type vec;
+
+/* all arrays are aligned for and padded to the width of a pack */
+const std::size_t align = sizeof(vec);
+
+/* [zl,-zu] = [xl,-xu] * [yl,-yu], as dp_simd::mul() */
+inline void mul(vec &zl, vec &zu, vec xl, vec xu, vec yl, vec yu)
+{
+	zl = pack::min(pack::min(pack::mul(xl, yl), pack::mul(xl, pack::neg(yu))),
+	               pack::min(pack::mul(pack::neg(xu), yl), pack::mul(xu, yu)));
+	zu = pack::min(pack::min(pack::mul(pack::neg(xl), yl), pack::mul(xl, yu)),
+	               pack::min(pack::mul(xu, yl), pack::mul(pack::neg(xu), yu)));
+}
+
+/* [zl,-zu] = [xl,-xu]^2, as dp_simd::square() */
+inline void square(vec &zl, vec &zu, vec xl, vec xu)
+{
+	vec m = pack::max(pack::max(xl, xu), pack::zero());
+	vec a = pack::max(pack::abs(xl), pack::abs(xu));
+	zl = pack::mul(m, m);
+	zu = pack::mul(pack::neg(a), a);
+}
+
+#define LOAD(p) pack::load((p) + i)
+#define STORE(p, v) pack::store((p) + i, v)
+
+} // namespace
+
+void REALVECTOR::allocate(std::size_t n)
+{
+	this->n = n;
+	padded = (n + pack::width - 1) / pack::width * pack::width;
+	if (!n)
+		return;
+	block = static_cast<char *>(::operator new(2 * padded * sizeof(double) + align));
+	uintptr_t p = (reinterpret_cast<uintptr_t>(block) + align - 1) & ~(uintptr_t)(align - 1);
+	lower = reinterpret_cast<double *>(p);
+	upper_neg = lower + padded;
+	memset(lower, 0, 2 * padded * sizeof(double));
+}
+
+REALVECTOR::REALVECTOR(std::size_t n)
+{
+	allocate(n);
+}
+
+REALVECTOR::REALVECTOR(const std::vector<REAL> &x)
+{
+	allocate(x.size());
+	for (std::size_t i = 0; i < n; i++)
+		set(i, x[i]);
+}
+
+REALVECTOR::REALVECTOR(const REALMATRIX &x)
+{
+	allocate(std::size_t(x.maxrow) * x.maxcolumn);
+	for (std::size_t i = 0; i < n; i++)
+		set(i, x.values[i]);
+}
+
+REALVECTOR::REALVECTOR(const REALVECTOR &x)
+: mp(x.mp), spilled(x.spilled)
+{
+	allocate(x.n);
+	if (n)
+		memcpy(lower, x.lower, 2 * padded * sizeof(double));
+}
+
+REALVECTOR::REALVECTOR(REALVECTOR &&x) noexcept
+: n(x.n), padded(x.padded), block(x.block), lower(x.lower),
+  upper_neg(x.upper_neg), mp(std::move(x.mp)), spilled(x.spilled)
+{
+	x.n = x.padded = x.spilled = 0;
+	x.block = nullptr;
+	x.lower = x.upper_neg = nullptr;
+}
+
+REALVECTOR & REALVECTOR::operator=(const REALVECTOR &x)
+{
+	if (this != &x)
+		*this = REALVECTOR(x);
+	return *this;
+}
+
+REALVECTOR & REALVECTOR::operator=(REALVECTOR &&x) noexcept
+{
+	using std::swap;
+	swap(n, x.n);
+	swap(padded, x.padded);
+	swap(block, x.block);
+	swap(lower, x.lower);
+	swap(upper_neg, x.upper_neg);
+	swap(mp, x.mp);
+	swap(spilled, x.spilled);
+	return *this;
+}
+
+REALVECTOR::~REALVECTOR()
+{
+	::operator delete(block);
+}
+
+REAL REALVECTOR::operator[](std::size_t i) const
+{
+	if (is_mp(i))
+		return mp[i];
+	return interval(lower[i], upper_neg[i]);
+}
+
+void REALVECTOR::set(std::size_t i, const REAL &x)
+{
+	if (iRRAM_unlikely(!x.dp_only())) {
+		if (mp.empty())
+			mp.assign(n, interval(0.0, 0.0));
+		if (mp[i].dp_only())
+			spilled++;
+		/* operator= would turn x into a double interval */
+		REAL t(x);
+		swap(mp[i], t);
+		return;
+	}
+	lower[i] = x.dp.lower_pos;
+	upper_neg[i] = x.dp.upper_neg;
+	if (is_mp(i)) {
+		REAL t(x);
+		swap(mp[i], t);
+		spilled--;
+	}
+}
+
+std::vector<REAL> REALVECTOR::as_vector() const
+{
+	std::vector<REAL> r;
+	r.reserve(n);
+	for (std::size_t i = 0; i < n; i++)
+		r.push_back((*this)[i]);
+	return r;
+}
+
+REALMATRIX REALVECTOR::as_REALMATRIX() const
+{
+	REALMATRIX r(n, 1);
+	for (std::size_t i = 0; i < n; i++)
+		r.values[i] = (*this)[i];
+	return r;
+}
+
+static void check_sizes(const REALVECTOR &x, const REALVECTOR &y, const char *op)
+{
+	if (x.size() != y.size()) {
+		fprintf(stderr, "Error in %s real vectors of different sizes\n", op);
+		exit(1);
+	}
+}
+
+REALVECTOR operator+(const REALVECTOR &x, const REALVECTOR &y)
+{
+	check_sizes(x, y, "adding");
+	REALVECTOR z(x.n);
+	if (iRRAM_unlikely(!REALVECTOR::doubles(x, y))) {
+		for (std::size_t i = 0; i < x.n; i++)
+			z.set(i, x[i] + y[i]);
+		return z;
+	}
+	for (std::size_t i = 0; i < x.padded; i += pack::width) {
+		STORE(z.lower, pack::add(LOAD(x.lower), LOAD(y.lower)));
+		STORE(z.upper_neg, pack::add(LOAD(x.upper_neg), LOAD(y.upper_neg)));
+	}
+	return z;
+}
+
+REALVECTOR operator-(const REALVECTOR &x, const REALVECTOR &y)
+{
+	check_sizes(x, y, "subtracting");
+	REALVECTOR z(x.n);
+	if (iRRAM_unlikely(!REALVECTOR::doubles(x, y))) {
+		for (std::size_t i = 0; i < x.n; i++)
+			z.set(i, x[i] - y[i]);
+		return z;
+	}
+	for (std::size_t i = 0; i < x.padded; i += pack::width) {
+		STORE(z.lower, pack::add(LOAD(x.lower), LOAD(y.upper_neg)));
+		STORE(z.upper_neg, pack::add(LOAD(x.upper_neg), LOAD(y.lower)));
+	}
+	return z;
+}
+
+REALVECTOR operator*(const REALVECTOR &x, const REALVECTOR &y)
+{
+	check_sizes(x, y, "multiplying");
+	REALVECTOR z(x.n);
+	if (iRRAM_unlikely(!REALVECTOR::doubles(x, y))) {
+		for (std::size_t i = 0; i < x.n; i++)
+			z.set(i, x[i] * y[i]);
+		return z;
+	}
+	for (std::size_t i = 0; i < x.padded; i += pack::width) {
+		vec l, u;
+		mul(l, u, LOAD(x.lower), LOAD(x.upper_neg),
+		          LOAD(y.lower), LOAD(y.upper_neg));
+		STORE(z.lower, l);
+		STORE(z.upper_neg, u);
+	}
+	return z;
+}
+
+REALVECTOR operator*(const REAL &a, const REALVECTOR &x)
+{
+	REALVECTOR z(x.n);
+	if (iRRAM_unlikely(!REALVECTOR::dp_only(a) || x.spilled)) {
+		for (std::size_t i = 0; i < x.n; i++)
+			z.set(i, a * x[i]);
+		return z;
+	}
+	vec al = pack::set1(a.dp.lower_pos), au = pack::set1(a.dp.upper_neg);
+	for (std::size_t i = 0; i < x.padded; i += pack::width) {
+		vec l, u;
+		mul(l, u, al, au, LOAD(x.lower), LOAD(x.upper_neg));
+		STORE(z.lower, l);
+		STORE(z.upper_neg, u);
+	}
+	return z;
+}
+
+void axpy(const REAL &a, const REALVECTOR &x, REALVECTOR &y)
+{
+	check_sizes(x, y, "adding");
+	if (iRRAM_unlikely(!REALVECTOR::dp_only(a) || !REALVECTOR::doubles(x, y))) {
+		for (std::size_t i = 0; i < x.n; i++)
+			y.set(i, y[i] + a * x[i]);
+		return;
+	}
+	vec al = pack::set1(a.dp.lower_pos), au = pack::set1(a.dp.upper_neg);
+	for (std::size_t i = 0; i < x.padded; i += pack::width) {
+		vec l, u;
+		mul(l, u, al, au, LOAD(x.lower), LOAD(x.upper_neg));
+		STORE(y.lower, pack::add(LOAD(y.lower), l));
+		STORE(y.upper_neg, pack::add(LOAD(y.upper_neg), u));
+	}
+}
+
+REAL dot(const REALVECTOR &x, const REALVECTOR &y)
+{
+	check_sizes(x, y, "multiplying");
+	if (iRRAM_unlikely(!REALVECTOR::doubles(x, y))) {
+		REAL s = REALVECTOR::interval(0.0, 0.0);
+		for (std::size_t i = 0; i < x.n; i++)
+			s += x[i] * y[i];
+		return s;
+	}
+	vec sl = pack::zero(), su = pack::zero();
+	for (std::size_t i = 0; i < x.padded; i += pack::width) {
+		vec l, u;
+		mul(l, u, LOAD(x.lower), LOAD(x.upper_neg),
+		          LOAD(y.lower), LOAD(y.upper_neg));
+		sl = pack::add(sl, l);
+		su = pack::add(su, u);
+	}
+	return REALVECTOR::interval(pack::sum(sl), pack::sum(su));
+}
+
+REAL abs(const REALVECTOR &x)
+{
+	if (iRRAM_unlikely(x.spilled))
+		return abs(x.as_vector());
+	vec sl = pack::zero(), su = pack::zero();
+	for (std::size_t i = 0; i < x.padded; i += pack::width) {
+		vec l, u;
+		square(l, u, LOAD(x.lower), LOAD(x.upper_neg));
+		sl = pack::add(sl, l);
+		su = pack::add(su, u);
+	}
+	return sqrt(REALVECTOR::interval(pack::sum(sl), pack::sum(su)));
+}
+
+REALVECTOR operator*(const REALMATRIX &a, const REALVECTOR &x)
+{
+	if (a.maxcolumn != x.n) {
+		fprintf(stderr, "Error in multiplying real matrix and vector of different sizes\n");
+		exit(1);
+	}
+	REALVECTOR z(a.maxrow);
+	const REAL *row = a.values;
+	for (std::size_t i = 0; i < a.maxrow; i++, row += a.maxcolumn) {
+		/* double intervals: accumulate without creating REALs */
+		internal::double_pair s(0.0, 0.0);
+		std::size_t j = 0;
+		if (!x.spilled)
+			for (; j < x.n && REALVECTOR::dp_only(row[j]); j++)
+				s = internal::dp_ops::add(s, internal::dp_ops::mul(row[j].dp,
+				        internal::double_pair(x.lower[j], x.upper_neg[j])));
+		REAL r = REALVECTOR::interval(s.lower_pos, s.upper_neg);
+		for (; j < x.n; j++)
+			r += row[j] * x[j];
+		z.set(i, r);
+	}
+	return z;
+}
+
+} // namespace iRRAM
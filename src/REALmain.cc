@@ -26,7 +26,9 @@ MA 02111-1307, USA.
 #include <cstdlib>
 #include <cstdarg>
 #include <cstring>
+#include <climits>
 #include <vector>
+#include <fstream>
 
 #include <cfenv>
 
@@ -78,6 +80,48 @@ const int iRRAM_prec_steps=512;
 static int _iRRAM_prec_array[iRRAM_prec_steps];
 const int *const iRRAM_prec_array = _iRRAM_prec_array;
 
+precision_ladder::precision_ladder(const std::function<int(int)> &gen)
+: p(iRRAM_prec_steps)
+{
+	p[0] = 2100000000;
+	for (int i = 1; i < iRRAM_prec_steps; i++) {
+		p[i] = gen(i);
+		if (i > 1 && p[i] >= p[i - 1])
+			p[i] = p[i - 1];
+	}
+}
+
+precision_ladder precision_ladder::geometric(int start, int inc, double factor)
+{
+	int prec_inc = inc;
+	factor = std::sqrt(std::sqrt(factor));
+	return precision_ladder([&](int i) {
+		if (i == 1)
+			return start;
+		int r = start + prec_inc;
+		prec_inc = int(prec_inc * factor) + inc;
+		return r;
+	});
+}
+
+precision_ladder precision_ladder::doubling(int start)
+{
+	int prec = start;
+	return precision_ladder([&](int i) {
+		if (i > 1)
+			prec = prec > MP_min / 2 ? 2 * prec : MP_min;
+		return prec;
+	});
+}
+
+precision_ladder precision_ladder::linear(int start, int inc)
+{
+	return precision_ladder([=](int i) {
+		long long r = start + (long long)inc * (i - 1);
+		return r < MP_min ? MP_min : int(r);
+	});
+}
+
 void show_statistics()
 {
   cerr << "   MP-objects in use:  "<<MP_var_count<<"\n"; 
@@ -101,19 +145,39 @@ void show_statistics()
 		<<"["<<actual_stack().prec_step<<"]\n"; 
   else 
   cerr << "   basic precision:    double\n"; 
+  const precision_memory &pm = state->prec_memory;
+  if (pm.calls)
+    cerr << "   learned exec calls: "<<pm.calls<<", saved iterations: "
+         <<pm.skipped<<", missed warm starts: "<<pm.missed<<"\n";
+  if (state->deferred)
+    cerr << "   deferred reiterations: "<<state->deferred<<"\n";
+  if (state->checkpoints)
+    cerr << "   resumed checkpoints: "<<state->checkpoints->restored<<"\n";
+  if (state->cache_address) {
+    const cache_stats &cs = cache_statistics(*state);
+    cerr << "   multi-valued cache: "<<cs.bytes<<" of "<<cs.capacity
+         <<" bytes, at most "<<cs.max_bytes<<"\n";
+    for (const cache_type_stats &t : cs.types)
+      cerr << "     "<<t.name<<": "<<t.entries<<" entries, "<<t.bytes
+           <<" bytes, at most "<<t.max_entries<<"/"<<t.max_bytes
+           <<", replayed "<<t.hits<<"\n";
+  }
   if ( state->max_prec != 1) 
-    cerr << "   maximal precision:  "<<iRRAM_prec_array[state->max_prec]
+    cerr << "   maximal precision:  "<<state->prec_array[state->max_prec]
 		<<"["<<state->max_prec<<"]\n"; 
   else 
     cerr << "   maximal precision:  double\n"; 
 }
 
 internal::run::run(state_t &st)
+: run(st, st.prec_start)
+{}
+
+internal::run::run(state_t &st, int start_step, int step_inc)
 : st(st)
-, code(st.prec_start, stiff::abs{})
+, code(start_step, stiff::abs{})
+, step_inc(step_inc)
 {
-	ITERATION_DATA &actual_stack = st.ACTUAL_STACK;
-
 	if (iRRAM_unlikely(st.debug > 0)) {
 //		std::stringstream s;
 //		s << std::this_thread::get_id();
@@ -128,42 +192,138 @@ internal::run::run(state_t &st)
 	// set the correct rounding mode for REAL using double intervals):
 	fesetround(FE_DOWNWARD);
 
-	st.cache_active = new cachelist;
+	start();
+}
+
+/* the context is owned by a session, which also set the rounding mode */
+internal::run::run(state_t &st, mv_cache *cache_address)
+: st(st)
+, code(st.prec_start, stiff::abs{})
+, step_inc(4)
+, own_context(false)
+{
+	if (iRRAM_unlikely(st.debug > 0))
+		cerr << "\niRRAM (session) starting...\n";
+
+	st.cache_address = cache_address;
+
+	start();
+}
+
+void internal::run::start()
+{
+	ITERATION_DATA &actual_stack = st.ACTUAL_STACK;
 
 	if (iRRAM_unlikely(st.debug > 0))
 		st.max_prec = actual_stack.prec_step;
 
 	actual_stack.prec_policy = 1;
 	actual_stack.inlimit = 0;
-	st.highlevel = (actual_stack.prec_step > iRRAM_DEFAULT_PREC_START);
+	set_precision_levels(st);
+	st.cache_address->set_limit(st.cache_limit, st.cache_limit_error);
+}
+
+session::session()
+: st(*state)
+, cache_address(new mv_cache)
+, saved_round(fegetround())
+{
+	fesetround(FE_DOWNWARD);
+}
+
+session::~session()
+{
+	delete cache_address;
+	fesetround(saved_round);
 }
 
 void internal::run::loop_init()
 {
 	ITERATION_DATA &actual_stack = st.ACTUAL_STACK;
+	cancellation_point(st);
 	iRRAM::cout.rewind();
-	for (int n = 0; n < st.max_active; n++)
-		st.cache_active->id[n]->rewind();
+	st.cache_address->rewind();
+
+	if (st.checkpoints)
+		st.checkpoints->next = 0;
 
 	st.inReiterate = false;
+	st.reiterate_pending = false;
 	assert(actual_stack.inlimit == 0);
 	assert(st.highlevel == (actual_stack.prec_step > iRRAM_DEFAULT_PREC_START));
 }
 
+/* rough size of `vars` MPFR numbers at precision 2^prec */
+static std::size_t mp_bytes(int vars, int prec)
+{
+	return std::size_t(vars) * (sizeof(iRRAM_ext_mpfr_block) + sizeof(mp_limb_t) +
+	                            std::size_t(prec < 0 ? -prec : 0) / CHAR_BIT);
+}
+
+void check_exec_limits(state_t &st)
+{
+	const exec_limits &l = *st.limits;
+	if (l.seconds > 0 && std::chrono::steady_clock::now() >= st.deadline)
+		throw exec_limit_exceeded{exec_status::time_limit};
+	if (l.mp_memory) {
+		int vars = st.ext_mpfr_cache.ext_mpfr_var_count;
+		st.limits_peak_vars = max(st.limits_peak_vars, vars);
+		if (mp_bytes(vars, st.ACTUAL_STACK.actual_prec) > l.mp_memory)
+			throw exec_limit_exceeded{exec_status::memory_limit};
+	}
+}
+
 void internal::run::loop_fini(int p_end)
 {
 	ITERATION_DATA &actual_stack = st.ACTUAL_STACK;
 	assert(st.highlevel == (actual_stack.prec_step > iRRAM_DEFAULT_PREC_START));
 
 	int prec_skip = 0;
-	do {
-		prec_skip++;
-		code.inc_step(4);
-	} while ((actual_stack.actual_prec > p_end) &&
-		 (prec_skip != st.prec_skip));
+	int failed_step = actual_stack.prec_step;
+	bool try_dd = !st.highlevel && st.dd_prec && p_end >= st.dd_prec &&
+	              st.prec_array[failed_step + 1] >= st.dd_prec;
+	/* after the double-doubles did not suffice, the next exec()s likely
+	 * need more precision as well: only retry them now and then */
+	if (st.ddlevel)
+		st.dd_backoff = iRRAM_DD_BACKOFF;
+	else if (try_dd && st.dd_backoff > 0) {
+		st.dd_backoff--;
+		try_dd = false;
+	}
+	if (try_dd) {
+		/* try double-double intervals before MPFR */
+		code.inc_step(1);
+	} else {
+		/* the double-double step was an extra one: continue the ladder
+		 * from where a failure in the doubles would have led */
+		int inc = st.ddlevel && step_inc > 1 ? step_inc - 1 : step_inc;
+		do {
+			prec_skip++;
+			code.inc_step(inc);
+			inc = step_inc;
+		} while ((actual_stack.actual_prec > p_end) &&
+			 (prec_skip != st.prec_skip));
+	}
+
+	if (st.limits) {
+		const exec_limits &l = *st.limits;
+		if (l.max_prec_step && actual_stack.prec_step > l.max_prec_step) {
+			if (failed_step >= l.max_prec_step)
+				throw exec_limit_exceeded{exec_status::precision_limit};
+			code.inc_step(l.max_prec_step - actual_stack.prec_step);
+		}
+		/* the next iteration will need about as many numbers */
+		if (l.mp_memory && mp_bytes(st.limits_peak_vars, actual_stack.actual_prec) > l.mp_memory)
+			throw exec_limit_exceeded{exec_status::memory_limit};
+		check_exec_limits(st);
+	}
 
 	assert(actual_stack.inlimit == 0);
 
+	if (dump_path && !dump_exec_state(dump_path))
+		iRRAM_DEBUG1(1, "exec state could not be written to "
+		                << dump_path << "\n");
+
 	if (iRRAM_unlikely(st.debug > 0)) {
 		show_statistics();
 		if (st.max_prec <= actual_stack.prec_step)
@@ -174,20 +334,216 @@ void internal::run::loop_fini(int p_end)
 	}
 }
 
-internal::run::~run()
+internal::sub_exec_scope::sub_exec_scope(state_t &st)
+: st(st)
+, cache_address(st.cache_address)
+, checkpoints(st.checkpoints)
+, requests(st.requests)
+, outputs(st.outputs)
+, stack(st.ACTUAL_STACK)
+, inReiterate(st.inReiterate)
+, reiterate_pending(st.reiterate_pending)
+, pending_level(st.pending_level)
+, pending_prec_diff(st.pending_prec_diff)
+, pending_count(st.pending_count)
 {
-	iRRAM::cout.reset();
-	for (int n = 0; n < st.max_active; n++)
-		st.cache_active->id[n]->clear();
+	st.checkpoints = nullptr;
+	st.reiterate_pending = false;
+	/* the outer run only suspends, it is still in progress */
+	st.ACTUAL_STACK.inlimit = 0;
+}
+
+internal::sub_exec_scope::~sub_exec_scope()
+{
+	st.cache_address = cache_address;
+	st.checkpoints = checkpoints;
+	st.requests = requests;
+	st.outputs = outputs;
+	st.ACTUAL_STACK = stack;
+	st.inReiterate = inReiterate;
+	st.reiterate_pending = reiterate_pending;
+	st.pending_level = pending_level;
+	st.pending_prec_diff = pending_prec_diff;
+	st.pending_count = pending_count;
+	set_precision_levels(st);
+}
+
+/* the steps loop_fini() takes for reiterations that ask for no more
+ * precision than the failed iteration had, with the double-double step
+ * regardless of dd_backoff */
+int internal::run::iterations_to(int step) const
+{
+	int n = 0;
+	bool dd = false;
+	for (int s = st.prec_start; s < step; n++) {
+		if (s <= iRRAM_DEFAULT_PREC_START && st.dd_prec &&
+		    st.prec_array[s] >= st.dd_prec &&
+		    st.prec_array[s + 1] >= st.dd_prec) {
+			s += 1;
+			dd = true;
+		} else {
+			s += dd && step_inc > 1 ? step_inc - 1 : step_inc;
+			dd = false;
+		}
+	}
+	return n;
+}
+
+void internal::run::persist(const char *path)
+{
+	dump_path = path;
+	int step = restore_exec_state(path);
+	if (step > 0) {
+		iRRAM_DEBUG2(1, "resuming from %s at precision step %d\n",
+		             path, step);
+		code.inc_step(step - st.ACTUAL_STACK.prec_step);
+	}
+}
+
+internal::batch_context::~batch_context()
+{
+	delete cache_address;
+	delete checkpoints;
+}
+
+static void swap_context(state_t &st, internal::batch_context &c)
+{
+	using std::swap;
+	/* the cache of the run stays in place, it might belong to a session */
+	st.cache_address->swap(*c.cache_address);
+	swap(st.checkpoints, c.checkpoints);
+	swap(st.outputs, c.outputs);
+}
+
+void internal::run::batch_enter(batch_context &c)
+{
+	/* inputs seen for the first time use the clean context of the run */
+	if (c.cache_address)
+		swap_context(st, c);
+	code.inc_step(c.prec_step - st.ACTUAL_STACK.prec_step);
+	loop_init();
+}
+
+void internal::run::batch_leave(batch_context &c, bool done, int p_end)
+{
+	if (done) {
+		/* the run gets back the clean context */
+		if (c.cache_address) {
+			swap_context(st, c);
+			delete c.cache_address;
+			delete c.checkpoints;
+			c.cache_address = nullptr;
+			c.checkpoints = nullptr;
+		}
+		/* clean up the context for the next input, keeping the
+		 * capacity of the caches */
+		st.cache_address->clear();
+		delete st.checkpoints;
+		st.checkpoints = nullptr;
+		st.outputs = 0;
+		return;
+	}
+
+	loop_fini(p_end);
+	c.prec_step = st.ACTUAL_STACK.prec_step;
+	if (!c.cache_address) {
+		c.cache_address = new mv_cache;
+		c.cache_address->set_limit(st.cache_limit, st.cache_limit_error);
+	}
+	swap_context(st, c);
+}
+
+void checkpoint_list::record(std::unique_ptr<internal::checkpoint_slot> values,
+                             const state_t &st)
+{
+	if (next < records.size())
+		records.resize(next);
+	records.emplace_back();
+	internal::checkpoint_record &r = records.back();
+	r.values = std::move(values);
+	r.cache_pos = st.cache_address->position();
+	r.requests = st.requests;
+	next++;
+}
+
+const internal::checkpoint_record * checkpoint_list::find_usable()
+{
+	for (unsigned i = records.size(); i > next; i--)
+		if (records[i-1].values->usable())
+			return &records[i-1];
+	return nullptr;
+}
+
+void checkpoint_list::resume(const internal::checkpoint_record &r, state_t &st)
+{
+	st.cache_address->seek(r.cache_pos);
+	st.requests = r.requests;
+	next = &r - records.data() + 1;
+	restored++;
+	iRRAM_DEBUG2(1, "resuming from checkpoint %u\n", next - 1);
+}
+
+int internal::precision_memory_start(state_t &st, const std::string &key)
+{
+	precision_memory &pm = st.prec_memory;
+	pm.calls++;
+	auto it = pm.steps.find(key);
+	if (it == pm.steps.end())
+		return st.prec_start;
+	return max(st.prec_start, it->second - pm.hysteresis);
+}
+
+void internal::precision_memory_learn(const run &r, const std::string &key,
+                                      int start_step)
+{
+	precision_memory &pm = r.st.prec_memory;
+	int step = r.st.ACTUAL_STACK.prec_step;
+	if (start_step > r.st.prec_start) {
+		/* the iterations exec() would have needed to get here */
+		pm.skipped += r.iterations_to(start_step);
+		if (step != start_step)
+			pm.missed++;
+	}
+	pm.steps[key] = step;
+}
+
+bool save_precision_memory(const char *path)
+{
+	std::ofstream f(path);
+	for (const auto &e : state->prec_memory.steps)
+		f << e.second << " " << e.first << "\n";
+	f.close();
+	return !f.fail();
+}
 
-	st.max_active = 0;
-	delete st.cache_active;
-	delete st.cache_address;
+bool load_precision_memory(const char *path)
+{
+	std::ifstream f(path);
+	if (!f)
+		return false;
+	precision_memory &pm = state->prec_memory;
+	int step;
+	std::string key;
+	while (f >> step && std::getline(f >> std::ws, key))
+		pm.steps[key] = step;
+	return f.eof();
+}
 
+internal::run::~run()
+{
+	iRRAM::cout.reset();
 	if (iRRAM_unlikely(st.debug > 0)) {
 		show_statistics();
 		cerr << "iRRAM ending \n";
 	}
+
+	st.cache_address->statistics(st.last_cache);
+	st.cache_address->clear();
+	if (own_context)
+		delete st.cache_address;
+	st.cache_address = nullptr;
+	delete st.checkpoints;
+	st.checkpoints = nullptr;
 }
 
 } // namespace iRRAM
@@ -256,6 +612,16 @@ extern "C" int iRRAM_parse_args(struct iRRAM_init_options *opts, int *argc, char
 			             "Changed inital precision step to %d \n",
 			             opts->prec_start);
 		} else
+		if (!strncmp(argv[i], "--dd_prec=", 10)) {
+			int hi;
+			hi = atoi(&(argv[i][10]));
+			if (hi <= 0) {
+				iRRAM_set_dd_prec(hi);
+				iRRAM_DEBUG2(1, "Using double-double intervals "
+				                "down to precision 2^(%d)\n",
+				             iRRAM::state->dd_prec);
+			}
+		} else
 		if (!strcmp(argv[i], "-h") || !strcmp(argv[i], "--help")) {
 			fprintf(stderr,
 "Runtime parameters for the iRRAM library:\n"
@@ -264,6 +630,7 @@ extern "C" int iRRAM_parse_args(struct iRRAM_init_options *opts, int *argc, char
 "--prec_factor=x [%4g] basic factor for precision changes\n"
 "--prec_skip=n   [%4d] bound for precision increments skipped by heuristic\n"
 "--prec_start=n  [%4d] initial precision level\n"
+"--dd_prec=n     [%4d] precision reached by double-double intervals, 0: none\n"
 "--debug=n       [%4d] level of limits up to which debugging should happen\n"
 "-d                     debug mode, with level 1\n"
 "-h / --help            this help message\n",
@@ -272,6 +639,7 @@ extern "C" int iRRAM_parse_args(struct iRRAM_init_options *opts, int *argc, char
 			        opts->prec_factor,
 			        opts->prec_skip,
 			        opts->prec_start,
+			        iRRAM::state->dd_prec,
 			        opts->debug);
 		} else
 			continue;
@@ -294,23 +662,22 @@ extern "C" void iRRAM_initialize3(const struct iRRAM_init_options *opts)
 
 	MP_initialize;
 
-	_iRRAM_prec_array[0] = 2100000000;
-	_iRRAM_prec_array[1] = opts->starting_prec;
-	int prec_inc = opts->prec_inc;
-	double factor = std::sqrt(std::sqrt(opts->prec_factor));
-	if (state->debug)
+	const precision_ladder l = precision_ladder::geometric(
+		opts->starting_prec, opts->prec_inc, opts->prec_factor);
+	std::copy(l.data(), l.data() + iRRAM_prec_steps, _iRRAM_prec_array);
+	if (state->debug) {
 		cerr << "Basic precision bounds: "
 		     << "double[1]";
-	for (int i = 2; i < iRRAM_prec_steps; i++) {
-		_iRRAM_prec_array[i] = opts->starting_prec + prec_inc;
-		prec_inc = int(prec_inc * factor) + opts->prec_inc;
-		if (_iRRAM_prec_array[i] >= _iRRAM_prec_array[i - 1])
-			_iRRAM_prec_array[i] = _iRRAM_prec_array[i - 1];
-		else if (state->debug && ((i % 5 == 0) || (i < 10)))
-			cerr << " " << iRRAM_prec_array[i] << "[" << i << "]";
-	}
-	if (state->debug)
+		for (int i = 2; i < iRRAM_prec_steps; i++)
+			if (l[i] != l[i-1] && ((i % 5 == 0) || (i < 10)))
+				cerr << " " << l[i] << "[" << i << "]";
 		cerr << "\n";
+	}
+}
+
+extern "C" void iRRAM_set_dd_prec(int prec)
+{
+	iRRAM::state->dd_prec = prec;
 }
 
 extern "C" void iRRAM_initialize2(int *argc, char **argv)
@@ -68,6 +68,7 @@ orstream::orstream(std::string s, std::ios::openmode mod)
 	real_w = 20;
 	real_f = float_form::absolute;
 
+	reiteration_point();
 	if (get_cached(target)) {
 		/*    get_cached<unsigned int>(real_w);
 		    get_cached<unsigned int>(real_f);
@@ -99,6 +100,7 @@ irstream::irstream(std::string s, std::ios::openmode mod)
 		                "section!\n");
 		return;
 	}
+	reiteration_point();
 	if (get_cached(target))
 		return;
 	iRRAM_DEBUG1(2, "I/O-handler: Creating new input stream '"
@@ -143,6 +145,8 @@ static orstream & iRRAM_out(orstream * s, const PARAM & x)
 		return *s;
 	}
 	if (actual_stack().inlimit == 0 && s->_respect_iteration) {
+		/* a deferred reiteration may have chosen the wrong output */
+		reiteration_point();
 		single_valued code;
 		if (++state->requests > state->outputs) {
 			*s->target << x;
@@ -160,6 +164,8 @@ static orstream & iRRAM_out(orstream * s, const PARAM & x)
 		                "section!\n");                                 \
 		return *this;                                                  \
 	}                                                                      \
+	if (actual_stack().inlimit == 0 && _respect_iteration)                 \
+		reiteration_point();                                           \
 	x;                                                                     \
 	return *this;
 
@@ -195,6 +201,8 @@ orstream & orstream::operator<<(_SetRflags _f) { iRRAM_out2(real_f = _f._M_n); }
 
 orstream::~orstream()
 {
+	/* no reiteration_point() here: with a deferred reiteration pending,
+	 * inReiterate is set and iRRAM_outexec keeps the stream open */
 	if (++state->requests > state->outputs) {
 		if (target != &std::cout && _respect_iteration) {
 			iRRAM_DEBUG1(2, "I/O-handler: Closing handler for "
@@ -223,6 +231,7 @@ irstream::~irstream()
 		iRRAM_DEBUG1(2, "illegal input in continuous section!\n");     \
 		return *this;                                                  \
 	}                                                                      \
+	reiteration_point();                                                   \
 	if (!get_cached(VAR)) {                                                \
 		{ single_valued code; *target >> VAR; }                        \
 		put_cached(VAR);                                               \
@@ -250,6 +259,7 @@ irstream& irstream::operator>>(std::string& s)     {iRRAM_in(s);}
 		                "section!\n");                                 \
 		return *this;                                                  \
 	}                                                                      \
+	reiteration_point();                                                   \
 	if (!get_cached(s)) {                                                  \
 		{ single_valued code; *target >> s; }                          \
 		put_cached(s);                                                 \
@@ -267,6 +277,7 @@ irstream & irstream::operator>>(INTEGER & d) { iRRAM_in2(d, INTEGER); }
 		                "section!\n");                                 \
 		return VAR;                                                    \
 	}                                                                      \
+	reiteration_point();                                                   \
 	if (!get_cached(VAR)) {                                                \
 		{ single_valued code; STMNT; }                                 \
 		put_cached(VAR);                                               \
@@ -0,0 +1,128 @@
+/*
+
+dump.cc -- writing and reading the state of a running exec() to/from files
+
+This file is part of the iRRAM Library.
+
+The iRRAM Library is free software; you can redistribute it and/or modify
+it under the terms of the GNU Library General Public License as published by
+the Free Software Foundation; either version 2 of the License, or (at your
+option) any later version.
+
+The iRRAM Library is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Library General Public
+License for more details.
+
+You should have received a copy of the GNU Library General Public License
+along with the iRRAM Library; see the file COPYING.LIB.  If not, write to
+the Free Software Foundation, Inc., 59 Temple Place - Suite 330, Boston,
+MA 02111-1307, USA.
+*/
+
+/* Layout of a dump, all in the native byte order of the machine:
+ *
+ *   "iRRAMexe" u32 version u32 bits-per-limb
+ *   i32 prec_step  i32 actual_prec  i64 outputs
+ *   u64 n  followed by the n bytes of the tape of mv_cache
+ *
+ * MPFR and GMP numbers carry their limbs on the tape, so it can be written
+ * as it is. Pointers do not survive a restart: a tape holding some is not
+ * written. */
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <iRRAM/lib.h>
+
+namespace iRRAM {
+
+namespace {
+
+const char dump_magic[8] = { 'i','R','R','A','M','e','x','e' };
+const uint32_t dump_version = 2;
+
+template <typename T>
+inline void put_raw(std::ostream &o, const T &v)
+{
+	o.write(reinterpret_cast<const char *>(&v), sizeof(v));
+}
+
+template <typename T>
+inline bool get_raw(std::istream &i, T &v)
+{
+	return bool(i.read(reinterpret_cast<char *>(&v), sizeof(v)));
+}
+
+}
+
+bool dump_exec_state(const char *path)
+{
+	const state_t &st = *state;
+	std::string tmp = std::string(path) + ".tmp";
+	{
+		std::ofstream f(tmp, std::ios::binary | std::ios::trunc);
+		f.write(dump_magic, sizeof(dump_magic));
+		put_raw(f, dump_version);
+		put_raw(f, uint32_t(GMP_NUMB_BITS));
+		put_raw(f, int32_t(st.ACTUAL_STACK.prec_step));
+		put_raw(f, int32_t(st.ACTUAL_STACK.actual_prec));
+		put_raw(f, int64_t(st.outputs));
+		const mv_cache &c = *st.cache_address;
+		put_raw(f, uint64_t(c.size()));
+		f.write(c.data(), c.size());
+		if (c.contains<void *>() || c.contains<std::ostream *>() ||
+		    c.contains<std::istream *>() || !f.flush()) {
+			f.close();
+			std::remove(tmp.c_str());
+			return false;
+		}
+	}
+	/* replace the old dump only by a complete one */
+	if (std::rename(tmp.c_str(), path) != 0) {
+		std::remove(path);
+		if (std::rename(tmp.c_str(), path) != 0)
+			return false;
+	}
+	return true;
+}
+
+int restore_exec_state(const char *path)
+{
+	state_t &st = *state;
+	std::ifstream f(path, std::ios::binary);
+	char magic[sizeof(dump_magic)];
+	uint32_t version, bits;
+	int32_t prec_step, actual_prec;
+	int64_t outputs;
+	uint64_t n;
+	if (!f.read(magic, sizeof(magic)) ||
+	    memcmp(magic, dump_magic, sizeof(magic)) != 0 ||
+	    !get_raw(f, version) || version != dump_version ||
+	    !get_raw(f, bits) || bits != GMP_NUMB_BITS ||
+	    !get_raw(f, prec_step) || !get_raw(f, actual_prec) ||
+	    !get_raw(f, outputs) || !get_raw(f, n) ||
+	    prec_step < 1 || prec_step >= iRRAM_prec_steps)
+		return 0;
+	/* the tape is the rest of the file */
+	std::streampos at = f.tellg();
+	if (!f.seekg(0, std::ios::end) || uint64_t(f.tellg() - at) != n ||
+	    !f.seekg(at))
+		return 0;
+	std::vector<char> tape(n);
+	if (!f.read(tape.data(), n) ||
+	    !st.cache_address->assign(tape.data(), n)) {
+		st.cache_address->clear();
+		return 0;
+	}
+	if (st.prec_array[prec_step] != actual_prec)
+		iRRAM_DEBUG2(1, "precision ladder changed since the dump was "
+		                "written, continuing with step %d\n", prec_step);
+	st.outputs = outputs;
+	return prec_step;
+}
+
+} // namespace iRRAM
@@ -29,7 +29,7 @@ static REAL exp_approx(int prec, const REAL & x)
 	else
 		it = int(std::log(double(-prec))) * 4;
 
-	xs = scale(x - ln2() * s, -it);
+	xs = scale(fma(ln2(), -s, x), -it);
 
 	if (wd > 1) {
 		std::vector<REAL> xpow(wd);
@@ -52,7 +52,7 @@ static REAL exp_approx(int prec, const REAL & x)
 				f = 1;
 				for (int k = i; k < i + wd; k++)
 					f *= k;
-				xpow[j] = scale(xpow[j], t) / REAL(f);
+				xpow[j] = scale(std::move(xpow[j]), t) / REAL(f);
 				i = i + 1;
 				e += xpow[j];
 			}
@@ -78,13 +78,29 @@ static REAL exp_approx(int prec, const REAL & x)
 
 static int exp_bound(const REAL & x) { return (int)((round(x) + 1) * 1.443); }
 
+/* exp is monotonic, above 709 the upper bound overflows */
+bool internal::dp_exp(double_pair &z, const double_pair &x) noexcept
+{
+	double l = x.lower_pos, u = -x.upper_neg;
+	if (!iRRAM_LIBM_ULPS || !(l >= -DBL_MAX && u <= 709))
+		return false;
+	z = widen_libm(std::exp(l), std::exp(u));
+	if (z.lower_pos < 0)
+		z.lower_pos = 0;
+	return true;
+}
+
 REAL exp(const REAL & x)
 {
+	internal::double_pair z;
+	if (!x.value && !x.dd() && !state->highlevel && internal::dp_exp(z, x.dp))
+		return REAL(z);
+	/* also for the overflow test: the first iteration may not have run it */
+	single_valued code;
 	if (positive(x - 750001, 0)) {
 		fprintf(stderr, "Overflow in exp(x)\n");
 		exit(1);
 	}
-	single_valued code;
 	REAL y = limit_lip(exp_approx, exp_bound, x);
 	return y;
 }
@@ -163,7 +179,7 @@ static REAL log_agm_approx(int prec, const REAL & z)
 	int N = 25 - prec / 2;
 	precision_mode rel(7); // TODO: erh, what?
 	REAL delta1 = scale(z, -N);
-	REAL l = ln2()*(N+2) - scale(pi() / iterate(agm, REAL(1), delta1), -1);
+	REAL l = fms(ln2(), N + 2, scale(pi() / iterate(agm, REAL(1), delta1), -1));
 	return l;
 }
 
@@ -176,14 +192,29 @@ static REAL log_approx(int prec, const REAL & z)
 
 static bool log_domain(const REAL & x) { return (bool)(x > 1); }
 
+bool internal::dp_log(double_pair &z, const double_pair &x) noexcept
+{
+	double l = x.lower_pos, u = -x.upper_neg;
+	if (!iRRAM_LIBM_ULPS || !(l > 0 && u <= DBL_MAX))
+		return false;
+	z = widen_libm(std::log(l), std::log(u));
+	return true;
+}
+
 REAL log(const REAL & x)
 {
+	internal::double_pair z;
+	if (!x.value && !x.dd() && !state->highlevel && internal::dp_log(z, x.dp))
+		return REAL(z);
+	/* the choice of s must not be cached: the first iteration may not
+	 * have made it */
+	single_valued code;
 	// x.rcheck(200);
 	int s = size(x);
 	REAL y = sqrt(sqrt(scale(x, 2 - s)));
 	// y.rcheck(200);
 	y = limit_lip(log_approx, 2, log_domain, y);
-	return 4 * y + (s - 2) * ln2();
+	return fma(ln2(), s - 2, 4 * y);
 }
 
 } // namespace iRRAM
@@ -65,6 +65,7 @@ REAL limit_lip (REAL (*f)(int,const REAL&),
     try{
     iRRAM_DEBUG2(2,"trying to compute limit_lip1 with precision %d...\n",actual_stack().actual_prec);
     lim=f(env.saved_prec(),x_new);
+    reiteration_point();
     if (lim.error.exponent > env.saved_prec()) {
       env.inc_step(2);
       iRRAM_DEBUG2(2,"limit_lip1 too imprecise, increasing precision locally to %d...\n",actual_stack().actual_prec);
@@ -111,6 +112,7 @@ REAL limit_lip (REAL (*f)(int,const REAL&),
      try{
       iRRAM_DEBUG2(2,"trying to compute limit_lip1 with precision %d...\n",actual_stack().actual_prec);
     lim=f(env.saved_prec(),x_new);
+    reiteration_point();
     if (lim.error.exponent > env.saved_prec()) {
       env.inc_step(2);
       iRRAM_DEBUG2(2,"limit_lip1 too imprecise, increasing precision locally to %d...\n",actual_stack().actual_prec);
@@ -153,6 +155,7 @@ REAL limit_lip     (REAL (*f)(int, const REAL&, const REAL&),
     try {
       iRRAM_DEBUG2(2,"trying to compute limit_lip2 with precision %d...\n",actual_stack().actual_prec);
       lim=f(env.saved_prec(),x_new,y_new);
+      reiteration_point();
      if (lim.error.exponent > env.saved_prec()) {
       env.inc_step(2);
       iRRAM_DEBUG2(2,"limit_lip2 too imprecise, increasing precision locally to %d...\n",actual_stack().actual_prec);
@@ -233,7 +236,7 @@ REAL lipschitz (REAL (*f)(const REAL&),
   bool try_it=true;
   while (try_it) {
   try { try_it=false;
-        lip_result=f(x_new); }
+        lip_result=f(x_new); reiteration_point(); }
   catch ( Iteration it)  { try_it=true;
       env.inc_step(2);
       iRRAM_DEBUG2(2,"limit_lip2 failed, increasing precision locally to %d...\n",actual_stack().actual_prec);
@@ -407,6 +410,7 @@ REAL limit_hint    (REAL (*f)(int, const REAL&),
     try {
     iRRAM_DEBUG2(2,"trying to compute limit_hint1 with precicion 2^(%d)...\n",element);
     limnew=f(element,x);
+    reiteration_point();
     limnew_error = sizetype_add_power2(limnew.geterror(), element);
     if ( (! success) || sizetype_less(limnew_error,lim_error) ) {
       lim=limnew;
@@ -418,11 +422,11 @@ REAL limit_hint    (REAL (*f)(int, const REAL&),
       hintcopy=2*hintcopy;
       }
     success=1;
-    if (element>iRRAM_prec_array[1])break;
+    if (element>state->prec_array[1])break;
     element=element+hint;
   }
     catch ( Iteration it) {
-    if (element>iRRAM_prec_array[1])break;
+    if (element>state->prec_array[1])break;
     element=element+hintcopy;
     }}
   if ( ! success) {
@@ -456,6 +460,7 @@ REAL limit_hint    (REAL (*f)(int, const REAL&, const REAL&),
     try {
     iRRAM_DEBUG2(2,"trying to compute limit_hint1 with precicion 2^(%d)...\n",element);
     limnew=f(element,x,y);
+    reiteration_point();
     limnew_error = sizetype_add_power2(limnew.geterror(), element);
     if ( (! success) || sizetype_less(limnew_error,lim_error) ) {
       lim=limnew;
@@ -467,11 +472,11 @@ REAL limit_hint    (REAL (*f)(int, const REAL&, const REAL&),
       hintcopy=2*hintcopy;
       }
     success=1;
-    if (element>iRRAM_prec_array[1])break;
+    if (element>state->prec_array[1])break;
     element=element+hint;
   }
     catch ( Iteration it) {
-    if (element>iRRAM_prec_array[1])break;
+    if (element>state->prec_array[1])break;
     element=element+hintcopy;
     }}
   if ( ! success) {
@@ -507,6 +512,7 @@ REALMATRIX limit_lip (REALMATRIX (*f)(int,const REALMATRIX&),
    try {
      iRRAM_DEBUG2(2,"trying to compute limit_matrix_lip1 with precision %d...\n",actual_stack().actual_prec);
      limnew=f(env.saved_prec(),x_new);
+     reiteration_point();
      lim=limnew;
      lim.geterror(lim_error);
      if (lim_error.exponent > env.saved_prec()) {
@@ -618,6 +624,7 @@ REAL iteration (void (*f)(REAL&,REAL&,const int& param),
       REAL rcc=rc;
       diff_old_size=diff_size;
       f(lcc,rcc,param);
+      reiteration_point();
       lcc.geterror(error);
       lcc.seterror(no_error);
       lc=lcc-scale(REAL(int(error.mantissa)),error.exponent);
@@ -679,13 +686,14 @@ REAL limit (const FUNCTION<REAL,int> & f )
     try {
     iRRAM_DEBUG2(2,"trying to compute limit_FUNCTION with precicion 2^(%d)...\n",element);
     limnew=f(element);
+    reiteration_point();
     limnew_error = sizetype_add_power2(limnew.geterror(), element);
     if (firsttime ==2 ) if ( limnew_error.exponent > env.saved_prec(-1)) {
     iRRAM_DEBUG0(2,{cerr<<"computation not precise enough ("
                   << limnew_error.mantissa <<"*2^"<< limnew_error.exponent
                   <<"), trying normal p-sequence\n";});
        element_step=1;
-       element=4+iRRAM_prec_array[element_step];
+       element=4+state->prec_array[element_step];
        firsttime=1;
     }
     if ( firsttime != 0 || sizetype_less(limnew_error,lim_error) ) {
@@ -699,7 +707,7 @@ REAL limit (const FUNCTION<REAL,int> & f )
     firsttime=0;
     if (element<=env.saved_prec())break;
     element_step+=4;
-    element=iRRAM_prec_array[element_step];
+    element=state->prec_array[element_step];
     }
     catch ( Iteration it) {
       if ( firsttime==0) {
@@ -709,7 +717,7 @@ REAL limit (const FUNCTION<REAL,int> & f )
       if ( firsttime==2) {
       iRRAM_DEBUG1(2,"computation failed, trying normal p-sequence\n");
       element_step=1;
-      element=4+iRRAM_prec_array[element_step];
+      element=4+state->prec_array[element_step];
       firsttime=1;
       } else {
       iRRAM_DEBUG1(1,"computation of limit_FUNCTION failed totally\n");
@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <cstdio>
 #include <cstdlib>
 
@@ -200,13 +201,58 @@ static REAL sin_range_red1(int prec, const REAL & x)
 	return sin_neg ? -sin_abs : sin_abs;
 }
 
+// Whether [l,u] may contain a point 2pi*(k+offset) with an integer k, i.e.
+// an extremum of sin or cos. t = x/(2pi) - offset is computed with an error
+// of a few ulps of |x|/(2pi)+1, well below the margin m.
+static bool may_contain_extremum(double l, double u, double offset)
+{
+	const double inv_2pi = 0.15915494309189535;
+	double m = (std::fabs(l) + std::fabs(u) + 1) * (32 * DBL_EPSILON);
+	double tl = l * inv_2pi - offset, tu = u * inv_2pi - offset;
+	return std::floor(tu + m) >= std::ceil(tl - m);
+}
+
+// sin or cos on [l,u] from the values at the bounds and the extrema
+// 2pi*(k+max) and 2pi*(k+min) that [l,u] may contain
+static bool dp_sin_cos(internal::double_pair &z, const internal::double_pair &x,
+                       double f(double), double max, double min) noexcept
+{
+	double l = x.lower_pos, u = -x.upper_neg;
+	// larger arguments are left to the exact range reduction
+	if (!iRRAM_LIBM_ULPS || !(l >= -1048576 && u <= 1048576))
+		return false;
+	double fl = f(l), fu = f(u);
+	z = internal::widen_libm(std::min(fl, fu), std::max(fl, fu));
+	if (z.lower_pos < -1 || may_contain_extremum(l, u, min))
+		z.lower_pos = -1;
+	if (z.upper_neg < -1 || may_contain_extremum(l, u, max))
+		z.upper_neg = -1;
+	return true;
+}
+
+bool internal::dp_sin(double_pair &z, const double_pair &x) noexcept
+{
+	return dp_sin_cos(z, x, std::sin, 0.25, -0.25);
+}
+
+bool internal::dp_cos(double_pair &z, const double_pair &x) noexcept
+{
+	return dp_sin_cos(z, x, std::cos, 0, 0.5);
+}
+
 REAL cos(const REAL & x)
 {
+	internal::double_pair z;
+	if (!x.value && !x.dd() && !state->highlevel && internal::dp_cos(z, x.dp))
+		return REAL(z);
 	return limit_lip(sin_range_red1, 0, total_domain, x + pi() / 2);
 }
 
 REAL sin(const REAL & x)
 {
+	internal::double_pair z;
+	if (!x.value && !x.dd() && !state->highlevel && internal::dp_sin(z, x.dp))
+		return REAL(z);
 	return limit_lip(sin_range_red1, 0, total_domain, x);
 }
 
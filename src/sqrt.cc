@@ -31,6 +31,19 @@ static REAL root_approx(int prec, const REAL & x, int n)
 
 REAL root(const REAL & x, int n) { return limit(root_approx, x, n); }
 
+/* sqrt() is correctly rounded, i.e. rounded down by exec(), so s < ulp(s)
+ * + sqrt(x_U) and s*2^-52 >= ulp(s) give the upper bound. */
+bool internal::dp_sqrt(double_pair &z, const double_pair &x) noexcept
+{
+	double u = -x.upper_neg;
+	if (!(u >= 0 && u <= DBL_MAX))
+		return false;
+	double s = std::sqrt(u);
+	z = double_pair(x.lower_pos > 0 ? std::sqrt(x.lower_pos) : 0.0,
+	                -s - s * DBL_EPSILON);
+	return true;
+}
+
 #ifdef OLDSQRT
 #ifdef MP_mv_sqrt
 
@@ -134,6 +147,9 @@ REAL sqrt(const REAL & x) { return limit(sqrt_approx, x); }
  */
 REAL sqrt(const REAL & x)
 {
+	internal::double_pair z;
+	if (!x.value && !x.dd() && !state->highlevel && internal::dp_sqrt(z, x.dp))
+		return REAL(z);
 	if (!x.value)
 		(const_cast<REAL &>(x)).mp_make_mp();
 	MP_type zvalue;
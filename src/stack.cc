@@ -26,9 +26,13 @@ MA 02111-1307, USA.
 #include <cstdlib>
 #include <cstdarg>
 #include <cstring>
+#include <new>
 
 #include <iRRAM/core.h>
 #include <iRRAM/cache.h>
+#include <iRRAM/DYADIC.h>
+#include <iRRAM/INTEGER.h>
+#include <iRRAM/SWITCHES.h>
 
 //*************************************************************************************
 // runtime identification of the iRRAM version, cf. iRRAM_version.h
@@ -45,8 +49,305 @@ namespace iRRAM {
 
 iRRAM_TLS state_proxy<iRRAM_HAVE_TLS> state;
 
-mv_cache::mv_cache() = default;
-mv_cache::~mv_cache() = default;
+mv_cache::mv_cache()
+: types(builtin_tags)
+{
+	for (uint32_t t = 0; t < builtin_tags; t++)
+		types[t].tag = t;
+}
+
+mv_cache::~mv_cache()
+{
+	std::free(tape);
+}
+
+void mv_cache::swap(mv_cache &c) noexcept
+{
+	using std::swap;
+	swap(tape, c.tape);
+	swap(len, c.len);
+	swap(cap, c.cap);
+	swap(cur, c.cur);
+	swap(last, c.last);
+	swap(types, c.types);
+	swap(max_len, c.max_len);
+	swap(limit, c.limit);
+	swap(check, c.check);
+	swap(limit_error, c.limit_error);
+	swap(limit_hit, c.limit_hit);
+}
+
+void mv_cache::reserve(std::size_t n)
+{
+	std::size_t c = std::max(std::max(n, 2 * cap), std::size_t(4096));
+	char *t = static_cast<char *>(std::realloc(tape, c));
+	if (!t)
+		throw std::bad_alloc();
+	tape = t;
+	cap = c;
+	check = limit && !limit_hit ? std::min(cap, limit) : cap;
+}
+
+/* called by put() when the tape is about to exceed the capacity or the limit */
+void mv_cache::grow(std::size_t n)
+{
+	if (limit && !limit_hit && n > limit) {
+		if (limit_error)
+			throw iRRAM_Numerical_Exception(iRRAM_cache_overflow);
+		limit_hit = true;
+		fprintf(stderr, "iRRAM: warning: multi-valued cache exceeds "
+		                "its limit of %zu bytes\n", limit);
+	}
+	reserve(std::max(n, cap));
+}
+
+void mv_cache::set_limit(std::size_t bytes, bool error) noexcept
+{
+	limit = bytes;
+	limit_error = error;
+	limit_hit = false;
+	check = limit ? std::min(cap, limit) : cap;
+}
+
+cache_type_stats & mv_cache::user_stats(uint32_t tag)
+{
+	for (std::size_t i = builtin_tags; i < types.size(); i++)
+		if (types[i].tag == tag)
+			return types[i];
+	types.emplace_back();
+	types.back().tag = tag;
+	return types.back();
+}
+
+/* the tape was truncated: count its records again */
+void mv_cache::recount() noexcept
+{
+	for (cache_type_stats &t : types)
+		t.entries = t.bytes = 0;
+	for (std::size_t pos = 0; pos < len; ) {
+		std::size_t n = sizeof(internal::tape_header) +
+		                internal::tape_pad(header(pos)->size);
+		cache_type_stats &t = stats(header(pos)->tag);
+		t.entries++;
+		t.bytes += n;
+		pos += n;
+	}
+}
+
+static const char * const builtin_type_names[] = {
+	nullptr, "bool", "short", "unsigned short", "int", "unsigned int",
+	"long", "unsigned long", "long long", "unsigned long long",
+	"float", "double", "void*", "MP_type", "MP_int_type", "std::string",
+	"std::ostream*", "std::istream*", "DYADIC", "INTEGER",
+};
+
+void mv_cache::statistics(cache_stats &s) const
+{
+	s.bytes = len;
+	s.max_bytes = max_len;
+	s.capacity = cap;
+	s.limit = limit;
+	s.types.clear();
+	for (const cache_type_stats &t : types) {
+		if (!t.max_entries && !t.hits)
+			continue;
+		s.types.push_back(t);
+		constexpr std::size_t n = sizeof(builtin_type_names) /
+		                          sizeof(*builtin_type_names);
+		s.types.back().name = t.tag < n ? builtin_type_names[t.tag]
+		                                : "user type";
+	}
+}
+
+const cache_stats & cache_statistics(state_t &st)
+{
+	if (st.cache_address)
+		st.cache_address->statistics(st.last_cache);
+	return st.last_cache;
+}
+
+void cache_limit::set(std::size_t bytes, bool error)
+{
+	state_t &st = *state;
+	st.cache_limit = bytes;
+	st.cache_limit_error = error;
+	if (st.cache_address)
+		st.cache_address->set_limit(bytes, error);
+}
+
+uint32_t internal::tape_user_tag(const std::type_info &t) noexcept
+{
+	/* FNV-1a */
+	uint32_t h = 2166136261u;
+	for (const char *c = t.name(); *c; c++)
+		h = (h ^ uint8_t(*c)) * 16777619u;
+	return h | 0x80000000u;
+}
+
+namespace {
+struct dyadic_record {
+	int64_t exp;
+	int32_t prec;
+	int32_t kind; /* signed, see mpfr_custom_get_kind() */
+};
+}
+
+static std::size_t dyadic_limbs(mpfr_srcptr z)
+{
+	if (!mpfr_regular_p(z))
+		return 0;
+	std::size_t n = mpfr_custom_get_size(mpfr_get_prec(z)) / sizeof(mp_limb_t);
+	const mp_limb_t *d = static_cast<const mp_limb_t *>(mpfr_custom_get_significand(z));
+	std::size_t i = 0;
+	while (i < n && d[i] == 0)
+		i++;
+	return n - i;
+}
+
+std::size_t tape_codec<DYADIC>::size(const DYADIC &x) noexcept
+{
+	return sizeof(dyadic_record) + dyadic_limbs(x.value) * sizeof(mp_limb_t);
+}
+
+void tape_codec<DYADIC>::encode(void *p, const DYADIC &x) noexcept
+{
+	dyadic_record r;
+	r.prec = mpfr_get_prec(x.value);
+	r.kind = mpfr_custom_get_kind(x.value);
+	r.exp = mpfr_regular_p(x.value) ? mpfr_get_exp(x.value) : 0;
+	memcpy(p, &r, sizeof(r));
+	std::size_t n = mpfr_custom_get_size(r.prec) / sizeof(mp_limb_t);
+	std::size_t k = dyadic_limbs(x.value);
+	const mp_limb_t *d = static_cast<const mp_limb_t *>(mpfr_custom_get_significand(x.value));
+	memcpy(static_cast<char *>(p) + sizeof(r), d + (n - k), k * sizeof(mp_limb_t));
+}
+
+void tape_codec<DYADIC>::decode(const void *p, std::size_t size, DYADIC &x)
+{
+	dyadic_record r;
+	memcpy(&r, p, sizeof(r));
+	ext_mpfr_set_prec(x.value, r.prec);
+	int sign = r.kind < 0 ? -1 : 1;
+	switch (r.kind * sign) {
+	case MPFR_NAN_KIND:  mpfr_set_nan(x.value); return;
+	case MPFR_INF_KIND:  mpfr_set_inf(x.value, sign); return;
+	case MPFR_ZERO_KIND: mpfr_set_zero(x.value, sign); return;
+	}
+	/* make x a regular number, then overwrite its significand */
+	mpfr_set_si(x.value, sign, MPFR_RNDN);
+	std::size_t n = mpfr_custom_get_size(r.prec) / sizeof(mp_limb_t);
+	std::size_t k = (size - sizeof(r)) / sizeof(mp_limb_t);
+	mp_limb_t *d = static_cast<mp_limb_t *>(mpfr_custom_get_significand(x.value));
+	std::fill(d, d + (n - k), mp_limb_t(0));
+	memcpy(d + (n - k), static_cast<const char *>(p) + sizeof(r), k * sizeof(mp_limb_t));
+	mpfr_set_exp(x.value, r.exp);
+}
+
+std::size_t tape_codec<INTEGER>::size(const INTEGER &x) noexcept
+{
+	return sizeof(int64_t) + mpz_size(x.value) * sizeof(mp_limb_t);
+}
+
+void tape_codec<INTEGER>::encode(void *p, const INTEGER &x) noexcept
+{
+	int64_t n = x.value->_mp_size;
+	memcpy(p, &n, sizeof(n));
+	memcpy(static_cast<char *>(p) + sizeof(n), mpz_limbs_read(x.value),
+	       mpz_size(x.value) * sizeof(mp_limb_t));
+}
+
+void tape_codec<INTEGER>::decode(const void *p, std::size_t, INTEGER &x)
+{
+	int64_t n;
+	memcpy(&n, p, sizeof(n));
+	std::size_t k = n < 0 ? -n : n;
+	mp_limb_t *d = mpz_limbs_write(x.value, k ? k : 1);
+	memcpy(d, static_cast<const char *>(p) + sizeof(n), k * sizeof(mp_limb_t));
+	mpz_limbs_finish(x.value, n);
+}
+
+static bool valid_records(const char *p, std::size_t n);
+
+static bool valid_record(const internal::tape_header &h, const void *v)
+{
+	if (h.tag & 0x80000000u)
+		return valid_records(static_cast<const char *>(v), h.size);
+	switch (h.tag) {
+	case tape_codec<MP_type>::tag(): {
+		if (h.size < sizeof(__mpfr_struct))
+			return false;
+		mpfr_srcptr z = static_cast<mpfr_srcptr>(v);
+		mpfr_prec_t p = mpfr_get_prec(z);
+		if (p < MPFR_PREC_MIN || p > MPFR_PREC_MAX)
+			return false;
+		return h.size == sizeof(__mpfr_struct) +
+		                 (mpfr_regular_p(z) ? mpfr_custom_get_size(p) : 0);
+	}
+	case tape_codec<MP_int_type>::tag(): {
+		if (h.size < sizeof(__mpz_struct))
+			return false;
+		int n = static_cast<const __mpz_struct *>(v)->_mp_size;
+		return h.size == sizeof(__mpz_struct) +
+		                 std::size_t(n < 0 ? -n : n) * sizeof(mp_limb_t);
+	}
+	case tape_codec<std::string>::tag():
+		return true;
+	case tape_codec<DYADIC>::tag(): {
+		dyadic_record r;
+		if (h.size < sizeof(r))
+			return false;
+		memcpy(&r, v, sizeof(r));
+		/* an int32_t prec is below MPFR_PREC_MAX where longs have 64 bits */
+		if (r.prec < MPFR_PREC_MIN ||
+		    r.kind < -MPFR_REGULAR_KIND || r.kind > MPFR_REGULAR_KIND)
+			return false;
+		std::size_t k = h.size - sizeof(r);
+		if (r.kind == MPFR_REGULAR_KIND || r.kind == -MPFR_REGULAR_KIND)
+			return k % sizeof(mp_limb_t) == 0 && k > 0 &&
+			       k <= mpfr_custom_get_size(r.prec) &&
+			       r.exp >= mpfr_get_emin() && r.exp <= mpfr_get_emax();
+		return k == 0;
+	}
+	case tape_codec<INTEGER>::tag(): {
+		int64_t n;
+		if (h.size < sizeof(n))
+			return false;
+		memcpy(&n, v, sizeof(n));
+		return h.size == sizeof(n) + std::size_t(n < 0 ? -n : n) * sizeof(mp_limb_t);
+	}
+	default:
+		return h.tag >= 1 && h.tag <= 17 && h.size <= sizeof(long long);
+	}
+}
+
+/* records of user types contain a sequence of records themselves */
+static bool valid_records(const char *p, std::size_t n)
+{
+	for (std::size_t pos = 0; pos < n; ) {
+		const internal::tape_header *h =
+			reinterpret_cast<const internal::tape_header *>(p + pos);
+		if (n - pos < sizeof(*h) ||
+		    n - pos - sizeof(*h) < h->size ||
+		    !valid_record(*h, h + 1))
+			return false;
+		pos += std::min(n - pos, sizeof(*h) + internal::tape_pad(h->size));
+	}
+	return true;
+}
+
+bool mv_cache::assign(const char *p, std::size_t n)
+{
+	clear();
+	if (n > cap)
+		reserve(n);
+	memcpy(tape, p, n);
+	if (n % internal::tape_align || !valid_records(tape, n))
+		return false;
+	len = n;
+	recount();
+	max_len = std::max(max_len, len);
+	return true;
+}
 
 state_proxy<true>::state_proxy()
 : std::unique_ptr<state_t> { std::make_unique<state_t>() }
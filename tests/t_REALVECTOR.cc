@@ -0,0 +1,95 @@
+#include <iRRAM/lib.h>
+#include <cstdio>
+
+/* REALVECTOR against the same operations on std::vector<REAL>, both on
+ * double intervals and, after the reiteration, on MP-backed elements. */
+
+using namespace iRRAM;
+
+#define ERROR(...) do { printf(__VA_ARGS__); exit(1); } while (0)
+
+static int iterations;
+
+static void check(const char *op, const REAL &x, const REAL &y)
+{
+	if (!bound(x - y, -40))
+		ERROR("%s: wrong result in iteration %d\n", op, iterations);
+}
+
+static void check(const char *op, const REALVECTOR &x, const std::vector<REAL> &y)
+{
+	if (x.size() != y.size())
+		ERROR("%s: size %zu instead of %zu\n", op, x.size(), y.size());
+	for (std::size_t i = 0; i < y.size(); i++)
+		check(op, x[i], y[i]);
+}
+
+static int compute()
+{
+	iterations++;
+	const int n = 37; /* not a multiple of the SIMD width */
+	std::vector<REAL> a(n), b(n);
+	for (int i = 0; i < n; i++) {
+		a[i] = REAL(i * 7 % n - n / 2) / 3;
+		b[i] = REAL(i * 3 + 1) / 11 - 2;
+	}
+	REAL c = REAL(5) / 7;
+
+	REALVECTOR x(a), y(b);
+	std::vector<REAL> s(n), d(n), p(n), q(n), r(n);
+	for (int i = 0; i < n; i++) {
+		s[i] = a[i] + b[i];
+		d[i] = a[i] - b[i];
+		p[i] = a[i] * b[i];
+		q[i] = c * a[i];
+		r[i] = b[i] + c * a[i];
+	}
+	check("add", x + y, s);
+	check("sub", x - y, d);
+	check("mul", x * y, p);
+	check("scale", c * x, q);
+	REALVECTOR z = y;
+	axpy(c, x, z);
+	check("axpy", z, r);
+
+	REAL e = 0;
+	for (int i = 0; i < n; i++)
+		e += a[i] * b[i];
+	check("dot", dot(x, y), e);
+	check("abs", abs(x), abs(a));
+
+	REALMATRIX m(3, n);
+	std::vector<REAL> mx(3);
+	for (int i = 0; i < 3; i++) {
+		REAL t = 0;
+		for (int j = 0; j < n; j++) {
+			m(i, j) = REAL(i + j) / 5;
+			t += m(i, j) * a[j];
+		}
+		mx[i] = t;
+	}
+	check("matrix", m * x, mx);
+	check("column", REALVECTOR(x.as_REALMATRIX()), a);
+
+	/* an MP-backed element spills in the first iteration, too */
+	x.set(5, REAL(INTEGER(3)));
+	a[5] = 3;
+	check("spilled", x, a);
+	check("spilled dot", dot(x, x), dot(REALVECTOR(a), REALVECTOR(a)));
+	x.set(5, a[4]);
+	a[5] = a[4];
+	check("unspilled", x, a);
+
+	approx(c, -3000); /* needs reiterations */
+	return 0;
+}
+
+int main(int argc, char **argv)
+{
+	iRRAM_initialize2(&argc, argv);
+	exec(compute);
+	if (iterations < 2)
+		ERROR("test needs reiterations, got %d iterations\n", iterations);
+	printf("t_REALVECTOR: passed\n");
+	return 0;
+}
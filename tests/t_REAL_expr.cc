@@ -0,0 +1,85 @@
+#include <iRRAM/lib.h>
+#include <iRRAM/REAL_expr.h>
+#include <cstdio>
+
+/* Compares expressions evaluated by the templates of REAL_expr.h with the
+ * same expressions of REALs: in the first iteration the double intervals
+ * of the former have to be contained in those of the latter, and in every
+ * iteration both have to agree up to the error of the iteration. */
+
+using namespace iRRAM;
+
+#define ERROR(...) do { printf(__VA_ARGS__); exit(1); } while (0)
+
+static bool first_iteration;
+
+static void check(const char *name, const REAL &fused, const REAL &plain, bool dp)
+{
+	if (first_iteration && dp) {
+		if (fused.value)
+			ERROR("%s: no double interval in the first iteration\n", name);
+		if (fused.dp.lower_pos < plain.dp.lower_pos ||
+		    fused.dp.upper_neg < plain.dp.upper_neg)
+			ERROR("%s: [%a,%a] is wider than [%a,%a]\n", name,
+			      fused.dp.lower_pos, -fused.dp.upper_neg,
+			      plain.dp.lower_pos, -plain.dp.upper_neg);
+	}
+	if (!bound(fused - plain, -1000))
+		ERROR("%s: differs from the REAL expression\n", name);
+}
+
+#define CHECK(dp, fused, plain) check(#fused, fused, plain, dp)
+
+static REAL compute()
+{
+	first_iteration = !state->highlevel;
+	REAL a = REAL(3) / 7, b = sqrt(REAL(2)), c = -REAL(5) / 11;
+	REAL d = REAL(13) / 17, e = REAL(1) / 3, f = -REAL(9) / 4;
+	/* nonzero, but the double interval contains zero */
+	REAL t = b * b - 2 + scale(REAL(1), -60);
+	REAL p = pi();
+	bool dp = !a.value && !a.dd() && !b.value && !b.dd();
+
+	CHECK(dp, REAL(lazy(a)), a);
+	CHECK(dp, REAL(-lazy(a)), -a);
+	CHECK(dp, REAL(lazy(a) + b), a + b);
+	CHECK(dp, REAL(lazy(a) - b), a - b);
+	CHECK(dp, REAL(lazy(a) * b), a * b);
+	CHECK(dp, REAL(lazy(a) / b), a / b);
+	CHECK(dp, REAL(lazy(a) * b + c), a * b + c);
+	CHECK(dp, REAL(c + lazy(a) * b), c + a * b);
+	CHECK(dp, REAL(lazy(a) * b - c), a * b - c);
+	CHECK(dp, REAL(c - lazy(a) * b), c - a * b);
+	CHECK(dp, REAL(lazy(a) * b + lazy(c) * d), a * b + c * d);
+	CHECK(dp, REAL(lazy(a) * b - lazy(c) * d), a * b - c * d);
+	CHECK(dp, REAL(lazy(a) * b + lazy(c) * d - lazy(e) / f), a * b + c * d - e / f);
+	CHECK(dp, REAL(-lazy(a) * b + c), -a * b + c);
+	CHECK(dp, REAL(c - (-lazy(a)) * b), c + a * b);
+	CHECK(dp, REAL((lazy(a) + b) * (lazy(c) - d) / (lazy(e) + 1)),
+	      (a + b) * (c - d) / (e + 1));
+	CHECK(dp, REAL(lazy(a) * 3 + 2), a * 3 + 2);
+	CHECK(dp, REAL(5 - lazy(a) * b), 5 - a * b);
+	CHECK(dp, REAL(5 - 3 * lazy(a)), 5 - 3 * a);
+	CHECK(dp, REAL(7 / lazy(a) - b / 4), 7 / a - b / 4);
+	CHECK(dp, REAL(lazy(a) * 0.5 + 1.5), a * REAL(0.5) + REAL(1.5));
+	CHECK(dp, REAL(0.1 - lazy(a) * 0.1), REAL(0.1) - a * REAL(0.1));
+	CHECK(dp, REAL(lazy(b) / 0.3 + lazy(c) * d), b / REAL(0.3) + c * d);
+	CHECK(dp, REAL(111 - (1130 - 3000 / lazy(a)) / b), 111 - (1130 - 3000 / a) / b);
+	/* the double division fails */
+	CHECK(false, REAL(lazy(a) / t + b), a / t + b);
+	/* an MP-backed operand */
+	CHECK(false, REAL(lazy(a) * p + b * lazy(p)), a * p + b * p);
+	/* the target is an operand */
+	REAL x = a;
+	x = lazy(x) * x + x;
+	CHECK(false, x, a * a + a);
+	return x;
+}
+
+int main(int argc, char **argv)
+{
+	iRRAM_initialize2(&argc, argv);
+	exec(compute);
+	printf("t_REAL_expr: passed\n");
+	return 0;
+}
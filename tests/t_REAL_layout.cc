@@ -0,0 +1,133 @@
+#include <iRRAM/lib.h>
+#include <cstdio>
+
+/* The double interval of a REAL shares its storage with the MP fields.
+ * Checks that copying, moving, swapping and assigning between REALs of each
+ * representation keeps the values and leaves valid moved-from REALs, and that
+ * the in-place arithmetic gives the values of the plain one, in an iteration
+ * on doubles, one on double-doubles and one on MP numbers. */
+
+using namespace iRRAM;
+
+#define ERROR(...) do { printf(__VA_ARGS__); exit(1); } while (0)
+
+/* dp or error and vsize, value, and the pointer to the low parts of
+ * double-double bounds */
+static_assert(sizeof(REAL) <= 32, "REAL is larger than 32 bytes");
+
+static const char *tier;
+static bool seen_dd, seen_mp;
+
+static const char * repr(const REAL &x)
+{
+	return x.value ? "MP" : x.dd() ? "double-double" : "double";
+}
+
+/* outside of single_valued sections the results of bound() would be cached,
+ * and later iterations would replay those of the first one */
+static bool agrees(const REAL &x, const REAL &v)
+{
+	single_valued code;
+	return bool(bound(x - v, -40));
+}
+
+static void check(const char *what, const REAL &x, const REAL &v)
+{
+	if (!agrees(x, v))
+		ERROR("%s iteration, %s: wrong %s value\n", tier, what, repr(x));
+}
+
+/* moved-from REALs hold one of two values, depending on the representations */
+static void check_either(const char *what, const REAL &x, const REAL &v, const REAL &w)
+{
+	if (!agrees(x, v) && !agrees(x, w))
+		ERROR("%s iteration, %s: wrong %s value\n", tier, what, repr(x));
+}
+
+static void check_pair(const REAL &a, const REAL &b)
+{
+	REAL c(a);
+	check("copy", c, a);
+	c += 1;
+	check("copy is independent", a, c - 1);
+
+	REAL d(std::move(c));
+	check("move", d, a + 1);
+	check_either("moved-from", c, a + 1, 0);
+
+	REAL e(a);
+	e = b;
+	check("copy assignment", e, b);
+	e += 1;
+	check("copy assignment is independent", b, e - 1);
+
+	REAL f(a), g(b);
+	f = std::move(g);
+	check("move assignment", f, b);
+	check_either("moved-from", g, b, a);
+
+	REAL h(a), k(b);
+	swap(h, k);
+	check("swap", h, b);
+	check("swap", k, a);
+
+	REAL s(a);
+	s = static_cast<const REAL &>(s);
+	check("self assignment", s, a);
+	swap(s, s);
+	check("self swap", s, a);
+
+	REAL p(a);
+	p += b;
+	check("+=", p, a + b);
+	p -= b;
+	check("-=", p, a);
+	p *= b;
+	check("*=", p, a * b);
+	p /= b;
+	check("/=", p, a);
+	p *= 3;
+	p -= 1;
+	p /= 3;
+	check("int compound assignments", p, (a * 3 - 1) / 3);
+	check("rvalue +", REAL(a) + b, a + b);
+	check("rvalue -", REAL(a) - b, a - b);
+	check("rvalue *", REAL(a) * b, a * b);
+	check("rvalue /", REAL(a) / b, a / b);
+}
+
+static REAL compute()
+{
+	tier = state->ddlevel ? "dd" : state->highlevel ? "MP" : "dp";
+	REAL x = REAL(1) / 3, y = REAL(2) / 7;
+	/* always MP-backed */
+	REAL m = REAL(INTEGER(5)) / 9;
+	if (x.dd())
+		seen_dd = true;
+	if (x.value)
+		seen_mp = true;
+
+	std::vector<REAL> v = { x, y, m, -x, m * y };
+	for (const REAL &a : v)
+		for (const REAL &b : v)
+			check_pair(a, b);
+	std::vector<REAL> w(v);
+	v.insert(v.begin(), w.begin(), w.end());
+	for (std::size_t i = 0; i < w.size(); i++)
+		check("vector", v[i], w[i]);
+
+	/* enough for double-doubles, then too much for them */
+	if (!bound(x * 3 - 1, -90) || !bound(x * 3 - 1, -300))
+		ERROR("%s: wrong result\n", tier);
+	return x;
+}
+
+int main(int argc, char **argv)
+{
+	iRRAM_initialize2(&argc, argv);
+	exec(compute);
+	if (!seen_dd || !seen_mp)
+		ERROR("no iteration on double-doubles or MP numbers\n");
+	printf("t_REAL_layout: passed\n");
+	return 0;
+}
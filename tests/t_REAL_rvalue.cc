@@ -0,0 +1,103 @@
+#include <iRRAM/lib.h>
+#include <cstdio>
+
+/* Compares the operators on REAL rvalues, which compute into the MP value of
+ * a temporary operand, and the compound assignments, which compute into the
+ * MP value of their target, with the operators on lvalues, and checks that
+ * the MP values are indeed kept. */
+
+using namespace iRRAM;
+
+#define ERROR(...) do { printf(__VA_ARGS__); exit(1); } while (0)
+
+static void check(const char *name, const REAL &moved, const REAL &copied)
+{
+	if (!bound(moved - copied, -1000))
+		ERROR("%s: differs from the operator on lvalues\n", name);
+}
+
+#define CHECK(expr, plain) check(#expr, expr, plain)
+
+static void check_reuse(const char *name, const REAL &t, REAL (*f)(REAL &&))
+{
+	REAL u = t;
+	MP_type v = u.value;
+	REAL z = f(std::move(u));
+	if (v && z.value != v)
+		ERROR("%s: the MP value of the operand is not reused\n", name);
+}
+
+static REAL a, b, c, d;
+
+template <typename F>
+static void check_assign(const char *name, const REAL &t, F f, const REAL &plain)
+{
+	REAL u = t;
+	MP_type v = u.value;
+	f(u);
+	if (v && u.value != v)
+		ERROR("%s: the MP value of the target is not kept\n", name);
+	check(name, u, plain);
+}
+
+static REAL compute()
+{
+	a = REAL(3) / 7;
+	b = sqrt(REAL(2));
+	c = -REAL(5) / 11;
+	d = pi();
+	REAL ab = a + b, bc = b * c, abc = ab * c;
+
+	CHECK((a + b) * c - d, abc - d);
+	CHECK(d - (a + b) * c, d - abc);
+	CHECK((a + b) + (b * c), ab + bc);
+	CHECK((a + b) - (b * c), ab - bc);
+	CHECK((a + b) * (b * c), ab * bc);
+	CHECK((a + b) / (b * c), ab / bc);
+	CHECK(a + (b * c), a + bc);
+	CHECK(a - (b * c), a - bc);
+	CHECK(a * (b * c), a * bc);
+	CHECK(a / (b * c), a / bc);
+	CHECK((a + b) + 3, ab + 3);
+	CHECK((a + b) - 3, ab - 3);
+	CHECK(3 - (a + b), 3 - ab);
+	CHECK((a + b) * 3, ab * 3);
+	CHECK((a + b) / 3, ab / 3);
+	CHECK((a + b) * 0.5, ab * REAL(0.5));
+	/* the operand donating its value is also the other operand */
+	REAL t = ab;
+	CHECK(std::move(t) - t, REAL(0));
+	t = ab;
+	CHECK(std::move(t) / t, REAL(1));
+
+	check_reuse("(t*c)-d", ab, [](REAL &&t) { return std::move(t) * c - d; });
+	check_reuse("d-(t*c)", ab, [](REAL &&t) { return d - std::move(t) * c; });
+	check_reuse("d/t+1", ab, [](REAL &&t) { return d / std::move(t) + 1; });
+	check_reuse("3-t/7", ab, [](REAL &&t) { return 3 - std::move(t) / 7; });
+
+	check_assign("t+=c", ab, [](REAL &t) { t += c; }, ab + c);
+	check_assign("t-=c", ab, [](REAL &t) { t -= c; }, ab - c);
+	check_assign("t-=3", ab, [](REAL &t) { t -= 3; }, ab - 3);
+	check_assign("t*=c", ab, [](REAL &t) { t *= c; }, ab * c);
+	check_assign("t*=3", ab, [](REAL &t) { t *= 3; }, ab * 3);
+	check_assign("t/=c", ab, [](REAL &t) { t /= c; }, ab / c);
+	check_assign("t/=3", ab, [](REAL &t) { t /= 3; }, ab / 3);
+	check_assign("t*=t", ab, [](REAL &t) { t *= t; }, ab * ab);
+	check_assign("t=scale(t)", ab, [](REAL &t) { t = scale(std::move(t), -7); },
+	             scale(ab, -7));
+
+	/* forces the MP representation */
+	if (!bound(abc - ab * c, -1000))
+		ERROR("no MP representation reached\n");
+	return abc;
+}
+
+int main(int argc, char **argv)
+{
+	iRRAM_initialize2(&argc, argv);
+	exec(compute);
+	/* the MP values have to go before the state of this thread */
+	a = REAL(), b = REAL(), c = REAL(), d = REAL();
+	printf("t_REAL_rvalue: passed\n");
+	return 0;
+}
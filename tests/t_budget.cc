@@ -0,0 +1,60 @@
+#include <iRRAM/lib.h>
+#include <cstdio>
+
+using namespace iRRAM;
+
+#define ERROR(...) do { printf(__VA_ARGS__); exit(1); } while (0)
+
+static REAL pi_sum(int p)
+{
+	/* fails to reach 2^p below the precision limit */
+	return pi() + scale(REAL(1), p);
+}
+
+static bool undecidable()
+{
+	return bool(REAL(0) > 0);
+}
+
+int main(int argc, char **argv)
+{
+	iRRAM_initialize2(&argc, argv);
+
+	exec_limits l;
+	auto r = exec_bounded(l, [](int p){ return approx(pi(), p); }, -1000);
+	if (r.status != exec_status::success)
+		ERROR("unlimited exec_bounded failed: %d\n", int(r.status));
+
+	l.max_prec_step = 3;
+	r = exec_bounded(l, [](int p){ return approx(pi(), p); }, -100000);
+	if (r.status != exec_status::precision_limit)
+		ERROR("precision limit not hit: %d\n", int(r.status));
+
+	enclosure e = exec_enclosure(l, -100000, pi_sum, -100000);
+	if (e.status != exec_status::precision_limit || !e.valid)
+		ERROR("no enclosure at the precision limit\n");
+	if (!exec([](const enclosure &e){
+		REAL c(e.center), d = pi() - c;
+		return bool(bound(d, sizetype_log2(e.error) + 1));
+	}, e))
+		ERROR("enclosure does not contain pi\n");
+
+	l = exec_limits();
+	l.seconds = 0.2;
+	auto u = exec_bounded(l, undecidable);
+	if (u.status != exec_status::time_limit)
+		ERROR("time limit not hit: %d\n", int(u.status));
+
+	l = exec_limits();
+	l.mp_memory = 1 << 20;
+	u = exec_bounded(l, undecidable);
+	if (u.status != exec_status::memory_limit)
+		ERROR("memory limit not hit: %d\n", int(u.status));
+
+	e = exec_enclosure(exec_limits(), -200, pi_sum, -300);
+	if (e.status != exec_status::success || !e.valid || e.error.exponent > -200)
+		ERROR("unlimited exec_enclosure failed\n");
+
+	printf("t_budget: passed\n");
+	return 0;
+}
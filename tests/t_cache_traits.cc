@@ -0,0 +1,102 @@
+#include <iRRAM/lib.h>
+#include <cstdio>
+
+using namespace iRRAM;
+
+#define ERROR(...) do { printf(__VA_ARGS__); exit(1); } while (0)
+
+struct choice {
+	int index;
+	std::vector<int> picks;
+	std::string label;
+};
+
+namespace iRRAM {
+template <> struct cache_traits<choice> {
+	static void save(cache_writer &w, const choice &c)
+	{
+		w.write(c.index);
+		w.write(c.picks);
+		w.write(c.label);
+	}
+	static void load(cache_reader &r, choice &c)
+	{
+		r.read(c.index);
+		r.read(c.picks);
+		r.read(c.label);
+	}
+};
+}
+
+static int iterations, computed;
+
+/* a multi-valued choice made once per exec() */
+static choice pick(const REAL &x)
+{
+	choice c;
+	if (get_cached(c))
+		return c;
+	{
+		single_valued code;
+		computed++;
+		c.index = computed;
+		c.picks = { 1, size(x), 3 };
+		c.label = "choice " + std::to_string(computed);
+	}
+	put_cached(c);
+	return c;
+}
+
+static std::vector<choice> compute()
+{
+	iterations++;
+	REAL x = sqrt(REAL(2));
+	std::vector<choice> r = { pick(x), pick(x * x) };
+	std::vector<std::vector<bool>> b;
+	if (!get_cached(b)) {
+		b = { { true, false }, {}, { true } };
+		put_cached(b);
+	}
+	if (b.size() != 3 || b[0] != std::vector<bool>{ true, false } || b[2].size() != 1)
+		ERROR("vector<vector<bool>> not replayed\n");
+	approx(x, -3000); /* needs reiterations */
+	return r;
+}
+
+int main(int argc, char **argv)
+{
+	iRRAM_initialize2(&argc, argv);
+
+	static_assert(is_cacheable<choice>::value, "choice not cacheable");
+	static_assert(is_cacheable<std::vector<choice>>::value, "vector not cacheable");
+	static_assert(!is_cacheable<std::vector<char *>>::value, "char * cacheable");
+
+	std::vector<choice> r = exec(compute);
+	if (iterations < 2)
+		ERROR("test needs reiterations, got %d iterations\n", iterations);
+	if (computed != 2)
+		ERROR("choices computed %d times\n", computed);
+	if (r.size() != 2 || r[0].index != 1 || r[1].index != 2 ||
+	    r[1].label != "choice 2" || r[0].picks.size() != 3 || r[0].picks[2] != 3)
+		ERROR("unexpected result\n");
+
+	const cache_stats &cs = cache_statistics();
+	const cache_type_stats *user = nullptr; /* the records of choice */
+	for (const cache_type_stats &t : cs.types)
+		if (t.tag & 0x80000000u && t.max_entries == 2)
+			user = &t;
+	if (!user || user->hits < 2 || !cs.max_bytes)
+		ERROR("unexpected cache statistics\n");
+
+	try {
+		cache_limit limit(64, true);
+		exec(compute);
+		ERROR("cache limit not enforced\n");
+	} catch (const iRRAM_Numerical_Exception &e) {
+		if (e.type != iRRAM_cache_overflow)
+			ERROR("unexpected exception %d\n", e.type);
+	}
+
+	printf("t_cache_traits: passed\n");
+	return 0;
+}
@@ -0,0 +1,74 @@
+#include <iRRAM/lib.h>
+#include <cstdio>
+
+using namespace iRRAM;
+
+#define ERROR(...) do { printf(__VA_ARGS__); exit(1); } while (0)
+
+enum { N = 50 };
+
+static int steps, restored;
+
+/* N steps of x -> cos(x), then a result that needs 2^-1000: with settled
+ * checkpoints only the first iteration runs the loop */
+static DYADIC orbit(bool use_checkpoints, bool settle)
+{
+	REAL x = 1;
+	int i = 0;
+	if (use_checkpoints && restore_checkpoint(x, i))
+		restored++;
+	for (; i < N; i++) {
+		steps++;
+		x = cos(x);
+		/* a multi-valued decision replayed after the checkpoint */
+		int k = choose(x > REAL(0.7), x < REAL(0.8));
+		if (settle)
+			x = approx(x, -40 - k);
+		if (use_checkpoints)
+			checkpoint(x, i + 1);
+	}
+	return approx(x * pi(), -1000);
+}
+
+int main(int argc, char **argv)
+{
+	iRRAM_initialize2(&argc, argv);
+
+	DYADIC plain = exec(orbit, false, true);
+	int plain_steps = steps;
+	if (plain_steps <= N)
+		ERROR("no reiteration without checkpoints: %d steps\n", plain_steps);
+
+	steps = restored = 0;
+	DYADIC resumed = exec(orbit, true, true);
+	if (steps != N)
+		ERROR("%d steps with checkpoints, expected %d\n", steps, int(N));
+	if (restored < 1)
+		ERROR("no checkpoint restored\n");
+	if (state->checkpoints)
+		ERROR("checkpoints kept after exec()\n");
+	if (!exec([](const DYADIC &a, const DYADIC &b) {
+		return bool(bound(REAL(a) - REAL(b), -30));
+	}, plain, resumed))
+		ERROR("results with and without checkpoints differ\n");
+
+	/* an unsettled REAL is too imprecise for the next iteration */
+	steps = restored = 0;
+	exec(orbit, true, false);
+	if (restored)
+		ERROR("restored a checkpoint of an unsettled value\n");
+	if (steps <= N)
+		ERROR("loop not rerun for unsettled values: %d steps\n", steps);
+
+	/* no checkpoints in single_valued sections */
+	exec([]{
+		single_valued code;
+		checkpoint(1);
+		if (state->checkpoints)
+			ERROR("checkpoint taken in a single_valued section\n");
+		return 0;
+	});
+
+	printf("t_checkpoint: passed\n");
+	return 0;
+}
@@ -0,0 +1,84 @@
+#include <iRRAM/lib.h>
+#include <cstdio>
+#include <cstring>
+
+using namespace iRRAM;
+
+#define ERROR(...) do { printf(__VA_ARGS__); exit(1); } while (0)
+
+static int iterations;
+static DYADIC a0;
+static double d0;
+static INTEGER n0;
+
+/* approx(), as_double() and as_INTEGER() at double precision, replayed in
+ * reiterations up to 2000 bits */
+static int compute()
+{
+	DYADIC a = approx(pi(), -40);
+	double d = (REAL(1) / 3).as_double();
+	INTEGER n = (REAL(INTEGER("1000000000000000000000000000000")) / 7).as_INTEGER();
+	if (!iterations++) {
+		a0 = a;
+		d0 = d;
+		n0 = n;
+	} else if (!(a == a0) || d != d0 || n != n0) {
+		ERROR("iteration %d did not replay the results\n", iterations);
+	}
+	/* needs reiterations, without recording a DYADIC */
+	return size(sqrt(REAL(2)) * sqrt(REAL(2)) - 2 + scale(REAL(1), -2000));
+}
+
+static const cache_type_stats * type(const cache_stats &cs, const char *name)
+{
+	for (const cache_type_stats &t : cs.types)
+		if (t.name && !strcmp(t.name, name))
+			return &t;
+	return nullptr;
+}
+
+static std::size_t entries(const cache_stats &cs, const char *name)
+{
+	const cache_type_stats *t = type(cs, name);
+	return t ? t->max_entries : 0;
+}
+
+int main(int argc, char **argv)
+{
+	iRRAM_initialize2(&argc, argv);
+
+	exec(compute);
+	if (iterations < 2)
+		ERROR("no reiteration\n");
+
+	const cache_stats &cs = cache_statistics();
+	if (entries(cs, "DYADIC") != 1 || entries(cs, "double") != 1 ||
+	    entries(cs, "INTEGER") != 1)
+		ERROR("expected one record each of DYADIC, double and INTEGER\n");
+	/* nothing of the computations behind the results */
+	if (entries(cs, "MP_type") || entries(cs, "bool") || entries(cs, "MP_int_type"))
+		ERROR("intermediate values recorded\n");
+	if (type(cs, "DYADIC")->hits < 1 || type(cs, "double")->hits < 1 ||
+	    type(cs, "INTEGER")->hits < 1)
+		ERROR("records not replayed\n");
+
+	/* approx() to 2^-40 keeps just about 40 bits, not the 2000 of the
+	 * working precision; as_INTEGER() the two limbs of 10^30/7 */
+	std::size_t header = sizeof(internal::tape_header);
+	if (type(cs, "DYADIC")->max_bytes > header + 24 + sizeof(mp_limb_t))
+		ERROR("DYADIC record of %zu bytes\n", type(cs, "DYADIC")->max_bytes);
+	if (type(cs, "INTEGER")->max_bytes > header + 8 + 2 * sizeof(mp_limb_t))
+		ERROR("INTEGER record of %zu bytes\n", type(cs, "INTEGER")->max_bytes);
+	if (type(cs, "double")->max_bytes != header + sizeof(double))
+		ERROR("double record of %zu bytes\n", type(cs, "double")->max_bytes);
+
+	if (!exec([]{
+		return bool(bound(REAL(a0) - pi(), -40)) &&
+		       bool(bound(REAL(d0) - REAL(1) / 3, -52)) &&
+		       bool(bound(REAL(n0) - REAL(INTEGER("1000000000000000000000000000000")) / 7, 0));
+	}))
+		ERROR("wrong results\n");
+
+	printf("t_compact_cache: passed\n");
+	return 0;
+}
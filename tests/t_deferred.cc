@@ -0,0 +1,91 @@
+#include <iRRAM/lib.h>
+#include <cstdio>
+#include <iostream>
+#include <sstream>
+
+using namespace iRRAM;
+
+#define ERROR(...) do { printf(__VA_ARGS__); exit(1); } while (0)
+
+static int limit_hits;
+
+/* positive, but only decided with about 80 bits */
+static REAL tiny() { return REAL(1) / 3 * 3 - 1 + scale(REAL(1), -80); }
+
+/* a loop on poisoned values: the 65th deferral throws */
+static int count_positive()
+{
+	deferred_reiteration mode;
+	REAL eps = tiny();
+	int n = 0, i = 0;
+	try {
+		for (; i < 100; i++)
+			if (eps > 0)
+				n++;
+	} catch (const Iteration &) {
+		limit_hits++;
+		if (i != iRRAM_DEFER_REITERATION_LIMIT)
+			ERROR("Iteration thrown at comparison %d\n", i);
+		if (state->reiterate_pending)
+			ERROR("reiteration still pending after the Iteration\n");
+		try {
+			reiteration_point();
+		} catch (const Iteration &) {
+			ERROR("second Iteration for the same failure\n");
+		}
+		throw;
+	}
+	return n;
+}
+
+/* a few deferrals are unwound once at the end of exec() */
+static int iterations;
+
+static bool few()
+{
+	deferred_reiteration mode;
+	iterations++;
+	REAL eps = tiny();
+	bool r = true;
+	for (int i = 0; i < 10; i++)
+		if (!(eps > 0))
+			r = false;
+	return r;
+}
+
+/* output after a poisoned decision must wait for the reiteration */
+static bool printed()
+{
+	deferred_reiteration mode;
+	if (tiny() > 0)
+		cout << "pos";
+	else
+		cout << "neg";
+	return true;
+}
+
+int main(int argc, char **argv)
+{
+	iRRAM_initialize2(&argc, argv);
+
+	if (exec(count_positive) != 100)
+		ERROR("wrong count\n");
+	if (!limit_hits)
+		ERROR("no deferral reached the limit\n");
+
+	if (!exec(few))
+		ERROR("wrong result\n");
+	if (iterations < 2)
+		ERROR("deferred reiteration was not unwound\n");
+
+	std::ostringstream out;
+	std::streambuf *buf = std::cout.rdbuf(out.rdbuf());
+	exec(printed);
+	std::cout.rdbuf(buf);
+	if (out.str() != "pos")
+		ERROR("output after a deferred decision: '%s'\n",
+		      out.str().c_str());
+
+	printf("t_deferred: passed\n");
+	return 0;
+}
@@ -0,0 +1,235 @@
+#include <iRRAM/lib.h>
+#include <iRRAM/double_double.h>
+#include <cfenv>
+#include <cstdio>
+#include <mpfr.h>
+
+/* Checks that the double-double interval kernels enclose the exact results,
+ * computed with MPFR, and are not much wider than necessary. The last part
+ * runs a computation that needs the double-double iteration. */
+
+using namespace iRRAM;
+using namespace iRRAM::internal;
+
+#define ERROR(...) do { printf(__VA_ARGS__); exit(1); } while (0)
+
+/* enough for the exact sums and products of any double_double */
+enum { PREC = 5000 };
+
+static unsigned long long seed = 1;
+
+static double random_double(int emax)
+{
+	seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+	int e = int(seed >> 58) % emax - emax / 2;
+	double m = double(seed >> 11 & 0xfffffffffffffULL) / 0x10000000000000ULL;
+	switch (seed >> 8 & 7) {
+	case 0: return 0.0;
+	case 1: return 1.0;
+	default: return std::ldexp(seed >> 7 & 1 ? 1 + m : -1 - m, e);
+	}
+}
+
+static double_double random_dd()
+{
+	double h = random_double(40);
+	double l = seed & 1 ? 0.0 : std::ldexp(random_double(8), -55) * h;
+	return dd_ops::renorm(h, l);
+}
+
+struct mp {
+	mpfr_t v;
+	mp() { mpfr_init2(v, PREC); mpfr_set_zero(v, 1); }
+	mp(const double_double &a) : mp()
+	{
+		mpfr_set_d(v, a.hi, MPFR_RNDN);
+		mpfr_add_d(v, v, a.lo, MPFR_RNDN);
+	}
+	~mp() { mpfr_clear(v); }
+	mp(const mp &) = delete;
+};
+
+static bool le(const mp &a, const mp &b) { return mpfr_lessequal_p(a.v, b.v); }
+
+/* width of z beyond the exact interval [l,u], relative to s */
+static double excess(const dd_pair &z, const mp &l, const mp &u, const mp &s)
+{
+	mp zl(z.lower_pos), zu(dd_ops::neg(z.upper_neg)), d;
+	mpfr_sub(d.v, l.v, zl.v, MPFR_RNDN);
+	mpfr_add(d.v, d.v, zu.v, MPFR_RNDN);
+	mpfr_sub(d.v, d.v, u.v, MPFR_RNDN);
+	if (mpfr_zero_p(s.v))
+		return mpfr_get_d(d.v, MPFR_RNDN);
+	mpfr_div(d.v, d.v, s.v, MPFR_RNDN);
+	return std::fabs(mpfr_get_d(d.v, MPFR_RNDN));
+}
+
+static void print(const dd_pair &x)
+{
+	printf(" [%a%+a, %a%+a]", x.lower_pos.hi, x.lower_pos.lo,
+	       -x.upper_neg.hi, -x.upper_neg.lo);
+}
+
+static void check(const char *op, const dd_pair &x, const dd_pair &y,
+                  const dd_pair &z, const mp &l, const mp &u, const mp &s)
+{
+	mp zl(z.lower_pos), zu(dd_ops::neg(z.upper_neg));
+	const char *e = nullptr;
+	if (!le(zl, l) || !le(u, zu))
+		e = "not enclosed";
+	else if (excess(z, l, u, s) > std::ldexp(1.0, -100))
+		e = "too wide";
+	if (!e)
+		return;
+	printf("%s: %s:", op, e);
+	print(x);
+	print(y);
+	print(z);
+	printf("\n");
+	exit(1);
+}
+
+static dd_pair random_interval()
+{
+	double_double a = random_dd(), b = (seed & 6) ? random_dd() : a;
+	mp ma(a), mb(b);
+	if (!le(ma, mb))
+		std::swap(a, b);
+	return { a, dd_ops::neg(b) };
+}
+
+/* l = min, u = max of the exact f(a,b) over the bounds a of x and b of y */
+template <typename F>
+static void hull(mp &l, mp &u, mp &s, const dd_pair &x, const dd_pair &y, F f)
+{
+	double_double xb[2] = { x.lower_pos, dd_ops::neg(x.upper_neg) };
+	double_double yb[2] = { y.lower_pos, dd_ops::neg(y.upper_neg) };
+	for (int i = 0; i < 4; i++) {
+		mp a(xb[i / 2]), b(yb[i % 2]), lo, up;
+		f(lo.v, a.v, b.v, MPFR_RNDD);
+		f(up.v, a.v, b.v, MPFR_RNDU);
+		if (!i || !le(l, lo))
+			mpfr_set(l.v, lo.v, MPFR_RNDN);
+		if (!i || !le(up, u))
+			mpfr_set(u.v, up.v, MPFR_RNDN);
+		mpfr_abs(lo.v, lo.v, MPFR_RNDN);
+		mpfr_abs(up.v, up.v, MPFR_RNDN);
+		mpfr_max(s.v, s.v, lo.v, MPFR_RNDN);
+		mpfr_max(s.v, s.v, up.v, MPFR_RNDN);
+	}
+}
+
+static void check_kernels()
+{
+	for (int i = 0; i < 20000; i++) {
+		dd_pair x = random_interval(), y = random_interval(), z;
+		mp l, u, s;
+
+		hull(l, u, s, x, y, mpfr_add);
+		/* cancellation: relative to the operands */
+		mp ax(x.lower_pos), ay(y.lower_pos);
+		mpfr_abs(ax.v, ax.v, MPFR_RNDN);
+		mpfr_abs(ay.v, ay.v, MPFR_RNDN);
+		mpfr_add(s.v, s.v, ax.v, MPFR_RNDN);
+		mpfr_add(s.v, s.v, ay.v, MPFR_RNDN);
+		check("add", x, y, dd_ops::add(x, y), l, u, s);
+
+		mp l2, u2, s2;
+		hull(l2, u2, s2, x, y, mpfr_mul);
+		check("mul", x, y, dd_ops::mul(x, y), l2, u2, s2);
+
+		mp l3, u3, s3;
+		hull(l3, u3, s3, x, x, mpfr_mul);
+		if (mpfr_sgn(l3.v) < 0)
+			mpfr_set_zero(l3.v, 1);
+		check("square", x, x, dd_ops::square(x), l3, u3, s3);
+
+		mp xl(x.lower_pos), xu(dd_ops::neg(x.upper_neg)), l4, u4, s4;
+		mpfr_abs(l4.v, xl.v, MPFR_RNDN);
+		mpfr_abs(u4.v, xu.v, MPFR_RNDN);
+		if (!le(l4, u4))
+			mpfr_swap(l4.v, u4.v);
+		if (mpfr_sgn(xl.v) < 0 && mpfr_sgn(xu.v) > 0)
+			mpfr_set_zero(l4.v, 1);
+		mpfr_set(s4.v, u4.v, MPFR_RNDN);
+		check("abs", x, x, dd_ops::abs(x), l4, u4, s4);
+
+		if (dd_ops::div(z, x, y)) {
+			mp yl(y.lower_pos), yu(dd_ops::neg(y.upper_neg));
+			if (mpfr_sgn(yl.v) <= 0 && mpfr_sgn(yu.v) >= 0)
+				ERROR("div: zero not detected\n");
+			mp l5, u5, s5;
+			hull(l5, u5, s5, x, y, mpfr_div);
+			check("div", x, y, z, l5, u5, s5);
+		}
+	}
+}
+
+static int steps = 20, iterations, dd_iterations;
+
+/* J.-M. Muller's sequence: needs about 80 bits for 20 steps, more than the
+ * 106 of double-doubles for 40 */
+static REAL compute()
+{
+	iterations++;
+	if (state->ddlevel)
+		dd_iterations++;
+	REAL a = REAL(11) / 2, b = REAL(61) / 11;
+	for (int i = 0; i < steps; i++) {
+		REAL c = 111 - (1130 - 3000 / a) / b;
+		a = b;
+		b = c;
+	}
+	if (!bound(a - 6, -1))
+		ERROR("Muller: wrong limit\n");
+	return a;
+}
+
+/* limits get double-double arguments but work on MP numbers */
+static DYADIC elementary(int i)
+{
+	if (state->ddlevel)
+		dd_iterations++;
+	REAL x = REAL(i) / 100;
+	return approx(exp(sin(x)), -66);
+}
+
+int main(int argc, char **argv)
+{
+	iRRAM_initialize2(&argc, argv);
+	int r = fegetround();
+	fesetround(FE_DOWNWARD);
+	check_kernels();
+	fesetround(r);
+
+	exec(compute);
+	if (iterations != 2 || dd_iterations != 1)
+		ERROR("Muller: %d iterations, %d with double-double intervals\n",
+		      iterations, dd_iterations);
+
+	/* after the failed double-double iteration at 40 steps, exec() skips
+	 * them iRRAM_DD_BACKOFF times */
+	steps = 40;
+	dd_iterations = 0;
+	exec(compute);
+	if (dd_iterations != 1)
+		ERROR("Muller: %d double-double iterations for 40 steps\n",
+		      dd_iterations);
+	steps = 20;
+	for (int i = 0; i <= iRRAM_DD_BACKOFF; i++) {
+		dd_iterations = 0;
+		exec(compute);
+		if (dd_iterations != (i == iRRAM_DD_BACKOFF))
+			ERROR("Muller: %d double-double iterations in exec() %d "
+			      "after the failure\n", dd_iterations, i);
+	}
+
+	dd_iterations = 0;
+	for (int i = 0; i < 100; i++)
+		exec(elementary, i);
+	if (!dd_iterations)
+		ERROR("elementary functions: no double-double iteration\n");
+
+	printf("t_double_double: passed\n");
+	return 0;
+}
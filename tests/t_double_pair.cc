@@ -0,0 +1,95 @@
+#include <iRRAM/lib.h>
+#include <cfenv>
+#include <cstdio>
+
+/* Compares the SIMD kernels for the double intervals of REAL with the
+ * portable ones. Built with the default flags, with -mavx and with -mfma. */
+
+using namespace iRRAM;
+using namespace iRRAM::internal;
+
+#define ERROR(...) do { printf(__VA_ARGS__); exit(1); } while (0)
+
+#ifdef iRRAM_HAVE_SSE2
+
+static unsigned long long seed = 1;
+
+static double random_double()
+{
+	seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+	int e = int(seed >> 58) - 32;
+	double m = double(seed >> 11 & 0xfffff) / 0x100000;
+	switch (seed >> 8 & 7) {
+	case 0: return 0.0;
+	case 1: return -m;
+	case 2: return 1.0;
+	default: return std::ldexp(seed >> 7 & 1 ? m : -m, e);
+	}
+}
+
+static double_pair random_pair()
+{
+	double a = random_double(), b = (seed & 15) ? random_double() : a;
+	if (a > b)
+		std::swap(a, b);
+	return double_pair(a, -b);
+}
+
+static void check(const char *op, const double_pair &x, const double_pair &y,
+                  const double_pair &g, const double_pair &s)
+{
+	/* == also identifies 0.0 and -0.0 */
+	if (g.lower_pos == s.lower_pos && g.upper_neg == s.upper_neg)
+		return;
+	ERROR("%s: [%a,%a] [%a,%a]: generic [%a,%a], simd [%a,%a]\n", op,
+	      x.lower_pos, -x.upper_neg, y.lower_pos, -y.upper_neg,
+	      g.lower_pos, -g.upper_neg, s.lower_pos, -s.upper_neg);
+}
+
+int main()
+{
+#ifdef iRRAM_HAVE_AVX
+	if (!__builtin_cpu_supports("avx"))
+		return 77;
+#endif
+#ifdef __FMA__
+	if (!__builtin_cpu_supports("fma"))
+		return 77;
+#endif
+	fesetround(FE_DOWNWARD);
+
+	double_pair x(1.0, -3.0), n = dp_simd::neg(x);
+	if (n.lower_pos != -3.0 || n.upper_neg != 1.0)
+		ERROR("neg: [1,3] gives [%a,%a]\n", n.lower_pos, -n.upper_neg);
+
+	for (int i = 0; i < 1000000; i++) {
+		double_pair x = random_pair(), y = random_pair(), g, s;
+		int k = int(seed >> 40 & 0xff) - 128;
+		check("add", x, y, dp_generic::add(x, y), dp_simd::add(x, y));
+		check("sub", x, y, dp_generic::sub(x, y), dp_simd::sub(x, y));
+		check("neg", x, y, dp_generic::neg(x), dp_simd::neg(x));
+		check("mul", x, y, dp_generic::mul(x, y), dp_simd::mul(x, y));
+		double_pair z = random_pair();
+		check("fma", x, y, dp_generic::fma(x, y, z), dp_simd::fma(x, y, z));
+		check("square", x, y, dp_generic::square(x), dp_simd::square(x));
+		check("abs", x, y, dp_generic::abs(x), dp_simd::abs(x));
+		check("mul int", x, double_pair(k, -k),
+		      dp_generic::mul(x, k), dp_simd::mul(x, k));
+		if (k)
+			check("div int", x, double_pair(k, -k),
+			      dp_generic::div(x, k), dp_simd::div(x, k));
+		bool bg = dp_generic::div(g, x, y), bs = dp_simd::div(s, x, y);
+		if (bg != bs)
+			ERROR("div: [%a,%a] [%a,%a]: zero not detected\n",
+			      x.lower_pos, -x.upper_neg, y.lower_pos, -y.upper_neg);
+		if (bg)
+			check("div", x, y, g, s);
+	}
+
+	printf("t_double_pair: passed\n");
+	return 0;
+}
+
+#else
+int main() { return 77; }
+#endif
@@ -0,0 +1,130 @@
+#include <iRRAM/lib.h>
+#include <cfenv>
+#include <cstdio>
+#include <mpfr.h>
+
+/* Checks that the double interval versions of sqrt, exp, log, sin and cos
+ * enclose the exact values, computed with MPFR, on samples of the argument
+ * intervals, and that REALs stay double intervals in the first iteration. */
+
+using namespace iRRAM;
+using namespace iRRAM::internal;
+
+#define ERROR(...) do { printf(__VA_ARGS__); exit(1); } while (0)
+
+static unsigned long long seed = 1;
+
+static unsigned long long next()
+{
+	seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+	return seed >> 11;
+}
+
+/* uniform in [0,1) */
+static double uniform() { return double(next()) / 9007199254740992.0; }
+
+static double random_double(double range)
+{
+	switch (next() & 7) {
+	case 0: return 0.0;
+	case 1: return std::ldexp(uniform(), -int(next() % 1000));
+	default: return (2 * uniform() - 1) * range;
+	}
+}
+
+typedef bool kernel(double_pair &, const double_pair &);
+typedef int mpfr_fun(mpfr_ptr, mpfr_srcptr, mpfr_rnd_t);
+
+/* f(t) for t in x, and the extrema of sin and cos */
+static void check_point(const char *name, mpfr_fun f, const double_pair &x,
+                        const double_pair &z, double t)
+{
+	mpfr_t a, lo, up;
+	mpfr_inits2(200, a, lo, up, (mpfr_ptr)0);
+	mpfr_set_d(a, t, MPFR_RNDN);
+	f(lo, a, MPFR_RNDD);
+	f(up, a, MPFR_RNDU);
+	/* t outside of the domain, e.g. sqrt on [-1,1] */
+	bool ok = mpfr_nan_p(lo) ||
+	          (mpfr_cmp_d(lo, z.lower_pos) >= 0 && mpfr_cmp_d(up, -z.upper_neg) <= 0);
+	mpfr_clears(a, lo, up, (mpfr_ptr)0);
+	if (!ok)
+		ERROR("%s: [%a,%a] gives [%a,%a], missing f(%a)\n", name,
+		      x.lower_pos, -x.upper_neg, z.lower_pos, -z.upper_neg, t);
+}
+
+static void check(const char *name, kernel k, mpfr_fun f, double range,
+                  double extremum_period)
+{
+	int applied = 0;
+	for (int i = 0; i < 20000; i++) {
+		double a = random_double(range);
+		double b = (next() & 3) ? a : a + uniform() * std::ldexp(1.0, -int(next() % 50)) * range;
+		if (a > b)
+			std::swap(a, b);
+		double_pair x(a, -b), z;
+		if (!k(z, x))
+			continue;
+		applied++;
+		if (!(z.lower_pos <= -z.upper_neg))
+			ERROR("%s: [%a,%a] gives the empty [%a,%a]\n", name, a, b,
+			      z.lower_pos, -z.upper_neg);
+		if (a == b && -z.upper_neg - z.lower_pos > std::ldexp(std::fabs(z.lower_pos) + 1, -45))
+			ERROR("%s: %a gives the wide [%a,%a]\n", name, a,
+			      z.lower_pos, -z.upper_neg);
+		for (int j = 0; j < 4; j++)
+			check_point(name, f, x, z, j < 2 ? (j ? b : a) : a + (b - a) * uniform());
+		if (extremum_period) {
+			/* the doubles next to the extrema in [a,b] */
+			double e = std::ceil(a / extremum_period) * extremum_period;
+			for (int j = 0; j < 4 && e <= b; j++, e += extremum_period) {
+				for (double t : { std::nextafter(e, -1e300), e, std::nextafter(e, 1e300) })
+					if (a <= t && t <= b)
+						check_point(name, f, x, z, t);
+			}
+		}
+	}
+	if (applied < 5000)
+		ERROR("%s: applied to %d intervals only\n", name, applied);
+}
+
+static REAL compute()
+{
+	REAL x = REAL(3) / 7;
+	REAL y[] = { sqrt(x), exp(x), log(x), sin(x), cos(x) };
+	/* without a bound for the C library only sqrt stays a double interval */
+	int n = iRRAM_LIBM_ULPS ? 5 : 1;
+	if (!state->highlevel)
+		for (int i = 0; i < n; i++)
+			if (y[i].value)
+				ERROR("first iteration: result is no double interval\n");
+	REAL e = sin(x) * sin(x) + cos(x) * cos(x) - 1 + square(sqrt(x)) - x + log(exp(x)) - x;
+	if (!bound(e, -40))
+		ERROR("first iteration: identities off by more than 2^-40\n");
+	return e;
+}
+
+int main(int argc, char **argv)
+{
+	iRRAM_initialize2(&argc, argv);
+	int r = fegetround();
+	fesetround(FE_DOWNWARD);
+	const double half_pi = 1.5707963267948966;
+	check("sqrt", dp_sqrt, mpfr_sqrt, 1e10, 0);
+	if (iRRAM_LIBM_ULPS) {
+		check("exp", dp_exp, mpfr_exp, 800, 0);
+		check("log", dp_log, mpfr_log, 1e300, 0);
+		check("sin", dp_sin, mpfr_sin, 100, half_pi);
+		check("cos", dp_cos, mpfr_cos, 100, half_pi);
+	} else {
+		double_pair z;
+		if (dp_exp(z, double_pair(1.0, -1.0)))
+			ERROR("exp: applied without a bound for the C library\n");
+	}
+	fesetround(r);
+
+	exec(compute);
+
+	printf("t_dp_elementary: passed\n");
+	return 0;
+}
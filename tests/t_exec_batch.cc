@@ -0,0 +1,63 @@
+#include <iRRAM/lib.h>
+#include <cstdio>
+#include <vector>
+
+using namespace iRRAM;
+
+#define ERROR(...) do { printf(__VA_ARGS__); exit(1); } while (0)
+
+enum { N = 10, HARD = 4 };
+
+static int first_step[N], last_step[N], iterations[N];
+
+/* sqrt(i) to 2^-20, which the first iteration delivers, but to 2^-1000 for
+ * input HARD */
+static DYADIC f(const int &i)
+{
+	if (!iterations[i]++)
+		first_step[i] = actual_stack().prec_step;
+	last_step[i] = actual_stack().prec_step;
+	return approx(sqrt(REAL(i)), i == HARD ? -1000 : -20);
+}
+
+int main(int argc, char **argv)
+{
+	iRRAM_initialize2(&argc, argv);
+
+	std::vector<int> in;
+	for (int i = 0; i < N; i++)
+		in.push_back(i);
+	std::vector<DYADIC> out = exec_batch(f, in);
+	if (out.size() != N)
+		ERROR("%zu results for %d inputs\n", out.size(), N);
+
+	for (int i = 0; i < N; i++) {
+		int p = i == HARD ? -990 : -18;
+		if (!exec([](const DYADIC &d, int i, int p) {
+			return bool(bound(REAL(d) - sqrt(REAL(i)), p));
+		}, out[i], i, p))
+			ERROR("wrong result for input %d\n", i);
+		if (first_step[i] != state->prec_start)
+			ERROR("input %d started at step %d\n", i, first_step[i]);
+		if (i != HARD && last_step[i] != state->prec_start)
+			ERROR("input %d reiterated up to step %d\n", i, last_step[i]);
+	}
+	if (iterations[HARD] < 2 || last_step[HARD] <= state->prec_start)
+		ERROR("input %d was not reiterated\n", int(HARD));
+
+	/* in a session, whose cache is still usable afterwards */
+	session s;
+	for (int i = 0; i < N; i++)
+		iterations[i] = 0;
+	out = s.exec_batch(f, in);
+	if (iterations[HARD] < 2 || iterations[0] != 1)
+		ERROR("session: %d and %d iterations\n", iterations[HARD],
+		      iterations[0]);
+	if (!s.exec([](const DYADIC &d) {
+		return bool(bound(REAL(d) - sqrt(REAL(HARD)), -990));
+	}, out[HARD]))
+		ERROR("session: wrong result for input %d\n", int(HARD));
+
+	printf("t_exec_batch: passed\n");
+	return 0;
+}
@@ -0,0 +1,95 @@
+#include <iRRAM/lib.h>
+#include <cstdio>
+
+/* Checks that the variables handed out by ext_mpfr_init() keep small
+ * significands inline, spill larger ones to the heap and move back, and that
+ * their values agree with plain MPFR variables at each precision, also when
+ * the precision is raised in place. */
+
+using namespace iRRAM;
+
+#define ERROR(...) do { printf(__VA_ARGS__); exit(1); } while (0)
+
+static const mpfr_prec_t inline_prec = iRRAM_EXT_MPFR_INLINE_LIMBS * GMP_NUMB_BITS;
+
+static void check_sqrt(mpfr_ptr z, mpfr_prec_t p)
+{
+	ext_mpfr_set_prec(z, p);
+	if (mpfr_get_prec(z) != p || !mpfr_nan_p(z))
+		ERROR("precision %ld: no NaN of that precision\n", (long)p);
+	if (ext_mpfr_is_inline(z) != (p <= inline_prec))
+		ERROR("precision %ld: inline is %d\n", (long)p, ext_mpfr_is_inline(z));
+	mpfr_sqrt_ui(z, 2, MPFR_RNDN);
+	mpfr_t r;
+	mpfr_init2(r, p);
+	mpfr_sqrt_ui(r, 2, MPFR_RNDN);
+	if (!mpfr_equal_p(z, r))
+		ERROR("precision %ld: sqrt(2) differs\n", (long)p);
+	mpfr_clear(r);
+}
+
+static void check_raise(mpfr_ptr z, mpfr_prec_t p, mpfr_prec_t q)
+{
+	ext_mpfr_set_prec(z, p);
+	mpfr_const_pi(z, MPFR_RNDN);
+	mpfr_t r;
+	mpfr_init2(r, p);
+	mpfr_set(r, z, MPFR_RNDN);
+	ext_mpfr_raise_prec(z, q);
+	if (mpfr_get_prec(z) != q || !mpfr_equal_p(z, r))
+		ERROR("raising %ld to %ld: value changed\n", (long)p, (long)q);
+	if (ext_mpfr_is_inline(z) != (q <= inline_prec))
+		ERROR("raising %ld to %ld: inline is %d\n", (long)p, (long)q,
+		      ext_mpfr_is_inline(z));
+	mpfr_clear(r);
+	ext_mpfr_set_prec(z, p);
+	mpfr_set_si(z, -1, MPFR_RNDN);
+	mpfr_div_ui(z, z, 0, MPFR_RNDN);
+	ext_mpfr_raise_prec(z, q);
+	if (!mpfr_inf_p(z) || mpfr_sgn(z) >= 0)
+		ERROR("raising %ld to %ld: -Inf changed\n", (long)p, (long)q);
+}
+
+static REAL compute()
+{
+	REAL x = sqrt(REAL(2)), y = exp(REAL(1) / 3);
+	/* forces precisions beyond the inline limbs */
+	if (!bound(x * x - 2, -3000) || !bound(log(y) * 3 - 1, -3000))
+		ERROR("REAL identities fail\n");
+	return x;
+}
+
+int main(int argc, char **argv)
+{
+	iRRAM_initialize2(&argc, argv);
+
+	iRRAM_ext_mpfr_cache_t cache;
+	ext_mpfr_initialize(&cache);
+	mpfr_ptr z = ext_mpfr_init(&cache);
+	if (!ext_mpfr_is_inline(z))
+		ERROR("a new variable is not inline\n");
+	mpfr_prec_t precs[] = { 10, inline_prec, inline_prec + 1, 5000,
+	                        100, 3000, 3000, 64, inline_prec };
+	for (mpfr_prec_t p : precs)
+		check_sqrt(z, p);
+	check_raise(z, 10, 70);
+	check_raise(z, 64, inline_prec);
+	check_raise(z, 100, inline_prec + 1);
+	check_raise(z, inline_prec + 1, 3000);
+	check_raise(z, 200, 200);
+	/* the pool hands back spilled and inline variables alike */
+	ext_mpfr_set_prec(z, 4000);
+	ext_mpfr_free(&cache, z);
+	mpfr_ptr w = ext_mpfr_init(&cache);
+	if (w != z || cache.total_alloc_var_count != 1)
+		ERROR("the freed variable is not reused\n");
+	check_sqrt(w, 200);
+	ext_mpfr_set_prec(w, 4000);
+	ext_mpfr_free(&cache, w);
+	ext_mpfr_finalize(&cache);
+
+	exec(compute);
+
+	printf("t_ext_mpfr: passed\n");
+	return 0;
+}
@@ -0,0 +1,113 @@
+#include <iRRAM/lib.h>
+#include <cfenv>
+#include <cstdio>
+#include <mpfr.h>
+
+/* Checks that fma() of double intervals encloses the exact values x*y+z,
+ * computed with MPFR, and that fma, fms and fmma of REALs agree with the
+ * unfused expressions in the first iteration and with MPFR numbers. Built
+ * with the default flags and with -mfma. */
+
+using namespace iRRAM;
+using namespace iRRAM::internal;
+
+#define ERROR(...) do { printf(__VA_ARGS__); exit(1); } while (0)
+
+static unsigned long long seed = 1;
+
+static unsigned long long next()
+{
+	seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+	return seed >> 11;
+}
+
+static double random_double()
+{
+	double m = double(next()) / 9007199254740992.0;
+	switch (next() & 7) {
+	case 0: return 0.0;
+	case 1: return 1.0;
+	default: return std::ldexp(next() & 1 ? m : -m, int(next() % 64) - 32);
+	}
+}
+
+static double_pair random_pair()
+{
+	double a = random_double(), b = (next() & 3) ? random_double() : a;
+	if (a > b)
+		std::swap(a, b);
+	return double_pair(a, -b);
+}
+
+static double point(const double_pair &x, int j)
+{
+	return j & 1 ? -x.upper_neg : x.lower_pos;
+}
+
+static void check(const char *name, const double_pair &x, const double_pair &y,
+                  const double_pair &z, const double_pair &r)
+{
+	mpfr_t t;
+	mpfr_init2(t, 4096);
+	for (int j = 0; j < 8; j++) {
+		mpfr_set_d(t, point(x, j), MPFR_RNDN);
+		mpfr_mul_d(t, t, point(y, j >> 1), MPFR_RNDN);
+		mpfr_add_d(t, t, point(z, j >> 2), MPFR_RNDN);
+		if (mpfr_cmp_d(t, r.lower_pos) < 0 || mpfr_cmp_d(t, -r.upper_neg) > 0)
+			ERROR("%s: [%a,%a]*[%a,%a]+[%a,%a] gives [%a,%a]\n", name,
+			      x.lower_pos, -x.upper_neg, y.lower_pos, -y.upper_neg,
+			      z.lower_pos, -z.upper_neg, r.lower_pos, -r.upper_neg);
+	}
+	mpfr_clear(t);
+	/* never wider than the product and the sum rounded separately */
+	double_pair u = dp_generic::add(dp_generic::mul(x, y), z);
+	if (r.lower_pos < u.lower_pos || r.upper_neg < u.upper_neg)
+		ERROR("%s: [%a,%a] is wider than [%a,%a]\n", name,
+		      r.lower_pos, -r.upper_neg, u.lower_pos, -u.upper_neg);
+}
+
+static const char *tier()
+{
+	return state->highlevel ? "higher iteration" : "first iteration";
+}
+
+static REAL compute()
+{
+	REAL x = REAL(3) / 7, y = sqrt(REAL(2)), z = -REAL(5) / 11;
+	if (!state->highlevel && fma(x, y, z).value)
+		ERROR("first iteration: fma is no double interval\n");
+	REAL e[] = {
+		fma(x, y, z) - (x * y + z),
+		fms(x, y, z) - (x * y - z),
+		fmma(x, y, z, x) - (x * y + z * x),
+		fma(x, 7, z) - (x * 7 + z),
+		/* exact cancellation */
+		fmma(x, y, -y, x),
+	};
+	for (const REAL &d : e)
+		if (!bound(d, -1000))
+			ERROR("%s: fused and unfused results differ\n", tier());
+	return e[0];
+}
+
+int main(int argc, char **argv)
+{
+	iRRAM_initialize2(&argc, argv);
+#ifdef __FMA__
+	if (!__builtin_cpu_supports("fma"))
+		return 77;
+#endif
+	int r = fegetround();
+	fesetround(FE_DOWNWARD);
+	for (int i = 0; i < 200000; i++) {
+		double_pair x = random_pair(), y = random_pair(), z = random_pair();
+		check("generic", x, y, z, dp_generic::fma(x, y, z));
+		check("ops", x, y, z, dp_ops::fma(x, y, z));
+	}
+	fesetround(r);
+
+	exec(compute);
+
+	printf("t_fma: passed\n");
+	return 0;
+}
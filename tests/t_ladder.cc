@@ -0,0 +1,87 @@
+#include <iRRAM/lib.h>
+#include <cstdio>
+#include <vector>
+
+using namespace iRRAM;
+
+#define ERROR(...) do { printf(__VA_ARGS__); exit(1); } while (0)
+
+static const precision_ladder fine = precision_ladder::linear(-50, -100);
+
+struct attempt { int step, prec; };
+static std::vector<attempt> seen;
+
+/* pi to 2^-1000, recording the precision of each iteration */
+static DYADIC compute()
+{
+	seen.push_back({actual_stack().prec_step, actual_stack().actual_prec});
+	return approx(pi(), -1000);
+}
+
+static void check_presets()
+{
+	precision_ladder geo = precision_ladder::geometric();
+	for (int i = 1; i < iRRAM_prec_steps; i++)
+		if (geo[i] != iRRAM_prec_array[i])
+			ERROR("default ladder differs at step %d: %d vs %d\n",
+			      i, iRRAM_prec_array[i], geo[i]);
+
+	for (int i = 1; i < 20; i++)
+		if (fine[i] != -50 - 100 * (i - 1))
+			ERROR("linear ladder: step %d is %d\n", i, fine[i]);
+
+	precision_ladder dbl = precision_ladder::doubling(-50);
+	for (int i = 1, p = -50; i < 20; i++, p *= 2)
+		if (dbl[i] != p)
+			ERROR("doubling ladder: step %d is %d\n", i, dbl[i]);
+
+	precision_ladder flat([](int i) { return i < 5 ? -50 * i : -100; });
+	for (int i = 5; i < iRRAM_prec_steps; i++)
+		if (flat[i] != flat[4])
+			ERROR("ladder not clamped at step %d: %d\n", i, flat[i]);
+}
+
+int main(int argc, char **argv)
+{
+	iRRAM_initialize2(&argc, argv);
+
+	check_presets();
+
+	DYADIC d;
+	{
+		use_ladder code(fine);
+		d = exec(compute);
+	}
+	if (state->prec_array != iRRAM_prec_array)
+		ERROR("use_ladder did not restore the default ladder\n");
+
+	if (seen.size() < 2)
+		ERROR("no reiteration in %zu iterations\n", seen.size());
+	for (std::size_t i = 0; i < seen.size(); i++) {
+		const attempt &it = seen[i];
+		if (it.prec != fine[it.step])
+			ERROR("iteration %zu at step %d used precision %d, not %d\n",
+			      i, it.step, it.prec, fine[it.step]);
+		if (i && it.step <= seen[i-1].step)
+			ERROR("iteration %zu did not advance from step %d\n",
+			      i, seen[i-1].step);
+	}
+	if (seen.back().prec > -1000)
+		ERROR("last iteration at precision %d\n", seen.back().prec);
+
+	/* a plain exec() is back on the default ladder */
+	seen.clear();
+	exec(compute);
+	for (const attempt &it : seen)
+		if (it.prec != iRRAM_prec_array[it.step])
+			ERROR("default ladder: step %d used precision %d\n",
+			      it.step, it.prec);
+
+	if (!exec([](const DYADIC &d) {
+		return bool(bound(REAL(d) - pi(), -990));
+	}, d))
+		ERROR("wrong result\n");
+
+	printf("t_ladder: passed\n");
+	return 0;
+}
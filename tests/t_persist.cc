@@ -0,0 +1,76 @@
+#include <iRRAM/lib.h>
+#include <sstream>
+#include <fstream>
+#include <cstdio>
+
+using namespace iRRAM;
+
+#define ERROR(...) do { printf(__VA_ARGS__); exit(1); } while (0)
+
+static const char *dump = "t_persist.dump";
+
+static int attempts;
+static int crash_at;
+
+struct crash {};
+
+static DYADIC compute(int p)
+{
+	attempts++;
+	cout << "start\n";
+	REAL x = sqrt(REAL(2));
+	DYADIC d = approx(x, -10);              /* cache<MP_type> */
+	bool gt(x > 1);                         /* cache<bool> */
+	int s = size(exp(REAL(100)));           /* cache<int> */
+	INTEGER k = (REAL(s) * x).as_INTEGER();       /* cache<MP_int_type> */
+	std::string w = swrite(x, 20);          /* cache<std::string> */
+	if (attempts == crash_at)
+		throw crash();
+	DYADIC r = approx(x, p);
+	if (!gt || w.empty())
+		ERROR("unexpected choices\n");
+	return r + d + DYADIC(k);
+}
+
+int main(int argc, char **argv)
+{
+	iRRAM_initialize2(&argc, argv);
+	std::remove(dump);
+
+	std::ostringstream out;
+	iRRAM::cout.target = &out;
+
+	DYADIC ref = exec(compute, -3000);
+	int ref_attempts = attempts;
+	if (ref_attempts < 4)
+		ERROR("test needs at least 4 iterations, got %d\n", ref_attempts);
+
+	out.str("");
+	attempts = 0;
+	crash_at = 3;
+	try {
+		exec_persistent(dump, compute, -3000);
+		ERROR("no crash\n");
+	} catch (const crash &) {
+	}
+	if (!std::ifstream(dump))
+		ERROR("no dump written\n");
+
+	attempts = 0;
+	crash_at = 0;
+	DYADIC r = exec_persistent(dump, compute, -3000);
+	if (attempts > ref_attempts - 2)
+		ERROR("resumed run took %d iterations, full run %d\n",
+		      attempts, ref_attempts);
+	if (std::ifstream(dump))
+		ERROR("dump not removed\n");
+	if (out.str() != "start\n")
+		ERROR("output repeated: '%s'\n", out.str().c_str());
+
+	iRRAM::cout.target = &std::cout;
+	if (!exec([](const DYADIC &a, const DYADIC &b){ return bool(bound(REAL(a) - REAL(b), -5000)); }, r, ref))
+		ERROR("resumed result differs\n");
+
+	printf("t_persist: passed\n");
+	return 0;
+}
@@ -0,0 +1,58 @@
+#include <iRRAM/lib.h>
+#include <cstdio>
+#include <vector>
+
+using namespace iRRAM;
+
+#define ERROR(...) do { printf(__VA_ARGS__); exit(1); } while (0)
+
+static const char *file = "t_precision_memory.txt";
+
+static std::vector<int> steps;
+
+/* positive, but comparisons only decide it at about 300 bits; each failed
+ * comparison asks for the next precision step only */
+static bool positive()
+{
+	steps.push_back(actual_stack().prec_step);
+	return bool(REAL(1) / 3 * 3 - 1 + scale(REAL(1), -300) > 0);
+}
+
+int main(int argc, char **argv)
+{
+	iRRAM_initialize2(&argc, argv);
+	precision_memory &pm = state->prec_memory;
+
+	if (!exec_learned("positive", positive))
+		ERROR("wrong result\n");
+	int cold = steps.size();
+	int learned = steps.back();
+	if (cold < 3)
+		ERROR("test needs at least 3 iterations, got %d\n", cold);
+
+	if (!save_precision_memory(file))
+		ERROR("could not write %s\n", file);
+	pm.steps.clear();
+	if (!load_precision_memory(file))
+		ERROR("could not read %s\n", file);
+	std::remove(file);
+	if (pm.steps.size() != 1 || pm.steps["positive"] != learned)
+		ERROR("loaded table differs\n");
+
+	steps.clear();
+	if (!exec_learned("positive", positive))
+		ERROR("wrong result\n");
+	if (steps.front() != learned - pm.hysteresis)
+		ERROR("warm start at step %d instead of %d\n", steps.front(),
+		      learned - pm.hysteresis);
+	/* all iterations of the cold start but the last one were below the
+	 * step of the warm start */
+	if (pm.skipped != cold - 1)
+		ERROR("%lld iterations counted as skipped, %d expected\n",
+		      pm.skipped, cold - 1);
+	if (pm.calls != 2 || pm.missed != (steps.size() > 1))
+		ERROR("statistics: %lld calls, %lld missed\n", pm.calls, pm.missed);
+
+	printf("t_precision_memory: passed\n");
+	return 0;
+}
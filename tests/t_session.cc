@@ -0,0 +1,71 @@
+#include <iRRAM/lib.h>
+#include <cfenv>
+#include <cstdio>
+
+using namespace iRRAM;
+
+#define ERROR(...) do { printf(__VA_ARGS__); exit(1); } while (0)
+
+static int first_step, iterations, rounding;
+
+/* the signs of sin(i) for i < n, then sqrt(n) to 2^-p */
+static DYADIC f(int n, int p)
+{
+	if (!iterations++)
+		first_step = actual_stack().prec_step;
+	rounding = fegetround();
+	int neg = 0;
+	for (int i = 0; i < n; i++)
+		neg += choose(sin(REAL(i)) < REAL(0.001), sin(REAL(i)) > REAL(-0.001)) == 1;
+	return approx(sqrt(REAL(n)) + neg, -p);
+}
+
+static bool agree(const DYADIC &a, const DYADIC &b, int p)
+{
+	return exec([](const DYADIC &a, const DYADIC &b, int p) {
+		return bool(bound(REAL(a) - REAL(b), p));
+	}, a, b, p);
+}
+
+int main(int argc, char **argv)
+{
+	iRRAM_initialize2(&argc, argv);
+
+	fesetround(FE_TONEAREST);
+	{
+		session s;
+		if (fegetround() != FE_DOWNWARD)
+			ERROR("session did not set the rounding mode\n");
+
+		/* many decisions and a reiteration */
+		iterations = 0;
+		DYADIC a = s.exec(f, 200, 1000);
+		if (iterations < 2)
+			ERROR("no reiteration in the first call\n");
+		if (rounding != FE_DOWNWARD)
+			ERROR("wrong rounding mode in session::exec()\n");
+		std::size_t bytes = cache_statistics().bytes;
+
+		/* nothing of the first call is replayed, and its capacity is kept */
+		iterations = 0;
+		DYADIC b = s.exec(f, 3, 20);
+		if (first_step != state->prec_start)
+			ERROR("second call started at step %d\n", first_step);
+		if (iterations != 1)
+			ERROR("second call took %d iterations\n", iterations);
+		const cache_stats &cs = cache_statistics();
+		if (cs.bytes >= bytes)
+			ERROR("cache of the first call kept: %zu bytes\n", cs.bytes);
+		if (cs.capacity < bytes)
+			ERROR("cache capacity %zu lost, now %zu\n", bytes, cs.capacity);
+
+		if (!agree(a, exec(f, 200, 1000), -990) ||
+		    !agree(b, exec(f, 3, 20), -18))
+			ERROR("session::exec() and exec() differ\n");
+	}
+	if (fegetround() != FE_TONEAREST)
+		ERROR("rounding mode not restored\n");
+
+	printf("t_session: passed\n");
+	return 0;
+}
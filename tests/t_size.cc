@@ -5,10 +5,26 @@ using namespace iRRAM;
 
 int count_low,count_high;
 
+/* the guarantees of upperbound(x) and bound(x,k) for x=d1 */
+inline void bchk(const REAL &x,double d1){
+  int u=upperbound(x);
+  if ( d1 != 0 && std::fabs(d1) >= std::ldexp(1.0,u+1) ){
+     cout << d1 << " "<< " " << u <<" upperbound ERROR! \n"; 
+     exit(1);
+  }
+  for (int k=-1000; k<1000; k+=37) {
+    bool b(bound(x,k));
+    if ( b ? std::fabs(d1) >= std::ldexp(1.0,k) : std::fabs(d1) < std::ldexp(1.0,k-2) ){
+      cout << d1 << " "<< " " << k <<" bound ERROR! \n"; 
+      exit(1);
+    }
+  }
+}
+
 inline void chk(int i,double &d1){
   REAL x;
   int d2;
-  x=d1; d2=size(x); 
+  x=d1; d2=size(x); bchk(x,d1);
   if  ( d2 < i || d2 > i+1){
      cout << d1 << " "<< " " << i <<" ERROR! \n"; 
      exit(1);
@@ -52,7 +68,14 @@ count_high=0;
  d1=-1.0;
  for (int i=1; i>-1000; i--){chk(i,d1);d1=d1/2;}
 
-REAL x=1.0;
+REAL x=0;
+ bchk(x,0.0);
+ if ( !bool(bound(x,-1150)) || x.as_double() != 0 ){
+     cout << "0 ERROR! \n"; 
+     exit(1);
+ }
+
+ x=1.0;
  for (int i=1; i<1000; i++) {
 	rchk(i,x+1);x=x*2;	rchk(i,x-1);
 	}
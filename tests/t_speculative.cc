@@ -0,0 +1,58 @@
+#include <iRRAM/speculative.h>
+#include <cstdio>
+
+/* exec_speculative() has to agree with exec() and its threads have to
+ * iterate like exec() in the calling thread would, on its precision ladder
+ * and with its settings. */
+
+using namespace iRRAM;
+
+#define ERROR(...) do { printf(__VA_ARGS__); exit(1); } while (0)
+
+static const precision_ladder ladder = precision_ladder::linear(-60, -40);
+static std::atomic<int> wrong_prec(0), wrong_setting(0), iterations(0);
+
+static DYADIC compute(int p)
+{
+	const state_t &st = *state;
+	const ITERATION_DATA &stack = actual_stack();
+	iterations++;
+	if (stack.actual_prec != ladder[stack.prec_step])
+		wrong_prec++;
+	if (st.dd_prec != -150 || st.cache_limit != (1 << 24) ||
+	    st.DYADIC_precision != -70)
+		wrong_setting++;
+	return approx(sqrt(REAL(2)) * pi(), p);
+}
+
+int main(int argc, char **argv)
+{
+	iRRAM_initialize2(&argc, argv);
+#if !iRRAM_HAVE_TLS
+	printf("t_speculative: skipped, no thread-local states\n");
+	return 77;
+#endif
+	state->dd_prec = -150;
+	state->DYADIC_precision = -70;
+	cache_limit limit(1 << 24);
+	use_ladder code(ladder);
+
+	DYADIC a = exec(compute, -2000);
+	iterations = 0;
+	DYADIC b = exec_speculative(compute, -2000);
+	if (!iterations)
+		ERROR("f was not called\n");
+	if (wrong_prec)
+		ERROR("%d of %d iterations not on the precision ladder\n",
+		      int(wrong_prec), int(iterations));
+	if (wrong_setting)
+		ERROR("%d of %d iterations without the settings of the caller\n",
+		      int(wrong_setting), int(iterations));
+	if (!exec([](const DYADIC &a, const DYADIC &b) {
+		return bool(bound(REAL(a) - REAL(b), -1998));
+	}, a, b))
+		ERROR("exec_speculative() differs from exec()\n");
+
+	printf("t_speculative: passed\n");
+	return 0;
+}
@@ -0,0 +1,78 @@
+#include <iRRAM/lib.h>
+#include <cstdio>
+#include <cmath>
+
+using namespace iRRAM;
+
+#define ERROR(...) do { printf(__VA_ARGS__); exit(1); } while (0)
+
+static int outer_step;
+
+/* the argument is exact in each iteration */
+static bool nested()
+{
+	outer_step = actual_stack().prec_step;
+	REAL s = sub_exec(-300, [](const REAL &a) { return sqrt(a); }, REAL(2));
+	return bool(bound(s * s - 2, -290));
+}
+
+/* the argument is only as precise as the enclosing iteration */
+static bool imprecise()
+{
+	outer_step = actual_stack().prec_step;
+	REAL a = REAL(1) / 3;
+	REAL y = sub_exec(-100, [](const REAL &a) { return a * a; }, a);
+	return bool(bound(y - REAL(1) / 9, -95));
+}
+
+/* the result of f has an error between 2^(tol-1) and 2^tol at the first
+ * inner step, its center 3*2^(tol-2) is off from the true value 0 */
+static int coarse_calls;
+
+static bool encloses()
+{
+	coarse_calls = 0;
+	REAL r = sub_exec(-100, []() {
+		if (coarse_calls++)
+			return REAL(0);
+		/* MP-backed, so that adderror() adds exactly e */
+		REAL y = scale(REAL(INTEGER(3)), -102);
+		sizetype e;
+		sizetype_set(e, 3, -102);
+		y.adderror(e);
+		return y;
+	});
+	DYADIC c;
+	sizetype e;
+	r.to_formal_ball(c, e);
+	return std::fabs(REAL(c).as_double()) <= std::ldexp(e.mantissa, e.exponent);
+}
+
+int main(int argc, char **argv)
+{
+	iRRAM_initialize2(&argc, argv);
+
+	exec_limits l;
+	l.seconds = 10;
+	auto r = exec_bounded(l, nested);
+	if (r.status != exec_status::success || !r.value)
+		ERROR("nested sub_exec failed: %d\n", int(r.status));
+
+	r = exec_bounded(l, imprecise);
+	if (r.status != exec_status::success)
+		ERROR("sub_exec with an imprecise argument did not finish: %d\n",
+		      int(r.status));
+	if (!r.value)
+		ERROR("sub_exec with an imprecise argument: wrong result\n");
+	if (outer_step <= state->prec_start)
+		ERROR("the enclosing exec was not reiterated\n");
+
+	r = exec_bounded(l, encloses);
+	if (r.status != exec_status::success || !r.value)
+		ERROR("sub_exec result does not contain the true value\n");
+	if (coarse_calls < 2)
+		ERROR("sub_exec accepted an error above 2^(tol-2)\n");
+
+	printf("t_sub_exec: passed\n");
+	return 0;
+}
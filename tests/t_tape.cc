@@ -0,0 +1,122 @@
+#include <iRRAM/lib.h>
+#include <cstdio>
+#include <vector>
+
+using namespace iRRAM;
+
+#define ERROR(...) do { printf(__VA_ARGS__); exit(1); } while (0)
+
+/* records of different types on one tape, replayed in order */
+static void check_replay(mv_cache &c)
+{
+	__mpfr_struct f;
+	mpfr_init2(&f, 300);
+	mpfr_const_pi(&f, MPFR_RNDN);
+	__mpz_struct z;
+	mpz_init_set_str(&z, "-123456789012345678901234567890", 10);
+
+	c.put(17);
+	c.put(0.25);
+	c.put(true);
+	c.put(mpfr_ptr(&f));
+	c.put(std::string("seven"));
+	c.put(mpz_ptr(&z));
+	c.put(18);
+
+	c.rewind();
+	int i;
+	double d;
+	bool b;
+	mpfr_ptr fv;
+	std::string s;
+	mpz_ptr zv;
+	if (!c.get(i) || i != 17 || !c.get(d) || d != 0.25 ||
+	    !c.get(b) || !b)
+		ERROR("raw records not replayed\n");
+	if (!c.get(fv) || mpfr_get_prec(fv) != 300 || mpfr_cmp(fv, &f))
+		ERROR("MPFR record not replayed\n");
+	if (!c.get(s) || s != "seven")
+		ERROR("string record not replayed\n");
+	if (!c.get(zv) || mpz_cmp(zv, &z))
+		ERROR("GMP record not replayed\n");
+	if (!c.get(i) || i != 18)
+		ERROR("last record not replayed\n");
+	if (c.get(i) || c.position() != c.size())
+		ERROR("replay beyond the end of the tape\n");
+
+	/* the numbers on the tape are independent of the originals */
+	mpfr_clear(&f);
+	mpz_clear(&z);
+	c.rewind();
+	c.get(i); c.get(d); c.get(b);
+	if (!c.get(fv) || mpfr_cmp_d(fv, 3.14159) < 0 || mpfr_cmp_d(fv, 3.1416) > 0)
+		ERROR("MPFR record refers to the original\n");
+}
+
+int main(int argc, char **argv)
+{
+	iRRAM_initialize2(&argc, argv);
+
+	mv_cache c;
+	check_replay(c);
+	std::size_t len = c.size();
+
+	/* a tape can be restored from its bytes */
+	std::vector<char> bytes(c.data(), c.data() + len);
+	mv_cache d;
+	if (!d.assign(bytes.data(), len) || d.size() != len)
+		ERROR("tape not assigned\n");
+	int i;
+	if (!d.get(i) || i != 17)
+		ERROR("assigned tape not replayed\n");
+	bytes[0] ^= 1; /* the tag of the first record */
+	bytes[4] = 0x7f; /* and its size */
+	if (d.assign(bytes.data(), len))
+		ERROR("invalid records assigned\n");
+
+	/* another path than recorded truncates the tape there */
+	c.rewind();
+	double x;
+	if (!c.get(i) || c.get(i))
+		ERROR("record of another type replayed\n");
+	if (c.size() != c.position())
+		ERROR("tape not truncated: %zu bytes, at %zu\n", c.size(), c.position());
+	if (c.get(x))
+		ERROR("replay after the truncation\n");
+
+	/* modify() in place and for the last record */
+	c.put(1.5);
+	c.rewind();
+	c.get(i);
+	c.get(x);
+	c.modify(2.5);
+	c.rewind();
+	if (!c.get(i) || !c.get(x) || x != 2.5)
+		ERROR("record not modified\n");
+	c.put(std::string("short"));
+	c.modify(std::string("longer than the record"));
+	c.put(3);
+	std::string s;
+	c.rewind();
+	c.get(i);
+	c.get(x);
+	if (!c.get(s) || s != "longer than the record" || !c.get(i) || i != 3)
+		ERROR("last record not replaced\n");
+
+	/* seek() to a recorded position, clear() keeps the capacity */
+	c.clear();
+	c.put(1);
+	std::size_t pos = c.position();
+	c.put(2);
+	c.put(3);
+	c.seek(pos);
+	if (!c.get(i) || i != 2)
+		ERROR("seek() to %zu failed\n", pos);
+	std::size_t cap = c.capacity();
+	c.clear();
+	if (c.size() || c.capacity() != cap || c.get(i))
+		ERROR("clear() did not empty the tape or lost its capacity\n");
+
+	printf("t_tape: passed\n");
+	return 0;
+}